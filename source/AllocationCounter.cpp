@@ -0,0 +1,65 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	//Constant initialized, so it counts the allocations of other static constructors too
+	std::atomic<uint64_t> nrHeapAllocations{};
+}
+
+namespace dae
+{
+	uint64_t GetNrHeapAllocations()
+	{
+		return nrHeapAllocations.load(std::memory_order_relaxed);
+	}
+}
+
+#if defined(COUNT_HEAP_ALLOCATIONS)
+//---------------------------
+// Replacement operators
+//---------------------------
+
+//The array and nothrow forms call these
+void* operator new(std::size_t size)
+{
+	nrHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pMemory{ std::malloc(size > 0 ? size : 1) }) return pMemory;
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	nrHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pMemory{ _aligned_malloc(size > 0 ? size : 1, static_cast<std::size_t>(alignment)) }) return pMemory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+	_aligned_free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+	_aligned_free(pMemory);
+}
+#endif
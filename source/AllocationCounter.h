@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+namespace dae
+{
+	//The replacement operators in AllocationCounter.cpp are only compiled with COUNT_HEAP_ALLOCATIONS (the Debug configuration),
+	//the normal build keeps the operators of the standard library
+#if defined(COUNT_HEAP_ALLOCATIONS)
+	constexpr bool isCountingHeapAllocations{ true };
+#else
+	constexpr bool isCountingHeapAllocations{ false };
+#endif
+
+	//Calls to operator new (every form) since the program started, always 0 without COUNT_HEAP_ALLOCATIONS.
+	//SDL and DirectX allocate through their own allocators, they are not counted.
+	uint64_t GetNrHeapAllocations();
+}
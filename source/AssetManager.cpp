@@ -0,0 +1,145 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "AssetManager.h"
+#include "Texture.h"
+#include "Mesh.h"
+#include "Effect.h"
+#include "ObjParser.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+//---------------------------
+// Constructor & Destructor
+//---------------------------
+
+AssetManager::AssetManager(ID3D11Device* pDevice)
+	:m_pDevice{ pDevice }
+{
+	//SDL_image initializes its decoders lazily, doing it up front keeps the workers from racing on it
+	IMG_Init(IMG_INIT_PNG);
+}
+
+AssetManager::~AssetManager()
+{
+	//The workers use the device, they have to be finished before it is released
+	WaitForAll();
+}
+
+//---------------------------
+// Member functions
+//---------------------------
+
+AssetHandle<Texture> AssetManager::LoadTexture(const std::string& path)
+{
+	const std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	const auto it{ m_Textures.find(path) };
+	if (it != m_Textures.end()) return it->second;
+
+	ID3D11Device* pDevice{ m_pDevice };
+	const AssetHandle<Texture> handle{ std::async(std::launch::async, [pDevice, path]()
+		{
+			std::shared_ptr<Texture> pTexture{ std::make_shared<Texture>(pDevice, path) };
+
+			if (!pTexture->GetResource())
+			{
+				std::cout << "Failed to load texture: " << path << '\n';
+				return std::shared_ptr<Texture>{};
+			}
+
+			return pTexture;
+		}).share() };
+
+	m_Textures.emplace(path, handle);
+	return handle;
+}
+
+AssetHandle<MeshData> AssetManager::LoadMesh(const std::string& path)
+{
+	const std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	const auto it{ m_Meshes.find(path) };
+	if (it != m_Meshes.end()) return it->second;
+
+	const AssetHandle<MeshData> handle{ std::async(std::launch::async, [path]()
+		{
+			std::shared_ptr<MeshData> pMeshData{ std::make_shared<MeshData>() };
+
+			if (!dae::Utils::ParseOBJFast(path, pMeshData->vertices, pMeshData->indices))
+			{
+				std::cout << "Failed to load mesh: " << path << '\n';
+				return std::shared_ptr<MeshData>{};
+			}
+
+			//The simplifier works on triangle lists, strips are made from its result
+			dae::Utils::GenerateLODs(*pMeshData, m_NrLODs);
+			dae::Utils::GenerateStrips(*pMeshData);
+
+			return pMeshData;
+		}).share() };
+
+	m_Meshes.emplace(path, handle);
+	return handle;
+}
+
+AssetHandle<const std::vector<char>> AssetManager::LoadEffect(const std::wstring& path)
+{
+	const std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	const auto it{ m_Effects.find(path) };
+	if (it != m_Effects.end()) return it->second;
+
+	const AssetHandle<const std::vector<char>> handle{ std::async(std::launch::async, [path]()
+		{
+			return Effect::CompileEffect(path);
+		}).share() };
+
+	m_Effects.emplace(path, handle);
+	return handle;
+}
+
+size_t AssetManager::GetNrPendingLoads() const
+{
+	const std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	size_t nrPending{};
+
+	for (const auto& texture : m_Textures)
+	{
+		nrPending += !texture.second.IsReady();
+	}
+
+	for (const auto& mesh : m_Meshes)
+	{
+		nrPending += !mesh.second.IsReady();
+	}
+
+	for (const auto& effect : m_Effects)
+	{
+		nrPending += !effect.second.IsReady();
+	}
+
+	return nrPending;
+}
+
+void AssetManager::WaitForAll() const
+{
+	const std::lock_guard<std::mutex> lock{ m_Mutex };
+
+	for (const auto& texture : m_Textures)
+	{
+		texture.second.Wait();
+	}
+
+	for (const auto& mesh : m_Meshes)
+	{
+		mesh.second.Wait();
+	}
+
+	for (const auto& effect : m_Effects)
+	{
+		effect.second.Wait();
+	}
+}
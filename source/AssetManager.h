@@ -0,0 +1,102 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+class Texture;
+struct MeshData;
+
+//-----------------------------------------------------
+// AssetHandle Class									
+//-----------------------------------------------------
+
+//Asset that is loaded on a worker thread, cheap to copy and can be polled every frame
+template<typename T>
+class AssetHandle final
+{
+public:
+	AssetHandle() = default;
+	explicit AssetHandle(std::shared_future<std::shared_ptr<T>> future)
+		:m_Future{ std::move(future) }
+	{
+	}
+
+	bool IsValid() const
+	{
+		return m_Future.valid();
+	}
+
+	bool IsReady() const
+	{
+		return IsValid() && m_Future.wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready;
+	}
+
+	void Wait() const
+	{
+		if (IsValid()) m_Future.wait();
+	}
+
+	//Blocks until the asset is loaded, nullptr when loading failed
+	std::shared_ptr<T> Get() const
+	{
+		return m_Future.get();
+	}
+
+private:
+	std::shared_future<std::shared_ptr<T>> m_Future{};
+};
+
+//-----------------------------------------------------
+// AssetManager Class									
+//-----------------------------------------------------
+
+//Loads every file once on a worker thread, requesting the same path again returns the same asset.
+//The assets stay alive as long as the manager, so raw pointers to them can be handed to meshes and effects.
+class AssetManager final
+{
+public:
+	AssetManager(ID3D11Device* pDevice);
+	~AssetManager();
+
+	// -------------------------
+	// Copy/move constructors and assignment operators
+	// -------------------------    
+	AssetManager(const AssetManager& other) = delete;
+	AssetManager(AssetManager&& other) noexcept = delete;
+	AssetManager& operator=(const AssetManager& other) = delete;
+	AssetManager& operator=(AssetManager&& other)	noexcept = delete;
+
+	//-------------------------------------------------
+	// Member functions						
+	//-------------------------------------------------
+
+	//Decodes the image and creates the DirectX resource on a worker (the device is free threaded)
+	AssetHandle<Texture> LoadTexture(const std::string& path);
+
+	//Parses the OBJ, simplifies it into levels of detail and converts those to triangle strips on a worker (the parser uses more workers itself), the DirectX buffers are created by the mesh on the calling thread
+	AssetHandle<MeshData> LoadMesh(const std::string& path);
+
+	//Compiles the effect on a worker, effects created from this file later on skip the compilation
+	AssetHandle<const std::vector<char>> LoadEffect(const std::wstring& path);
+
+	size_t GetNrPendingLoads() const;
+	void WaitForAll() const;
+
+private:
+	//-------------------------------------------------
+	// Datamembers								
+	//-------------------------------------------------
+	ID3D11Device* m_pDevice;
+
+	//Full detail included
+	static constexpr int m_NrLODs{ 4 };
+
+	mutable std::mutex m_Mutex{};
+
+	std::unordered_map<std::string, AssetHandle<Texture>> m_Textures{};
+	std::unordered_map<std::string, AssetHandle<MeshData>> m_Meshes{};
+	std::unordered_map<std::wstring, AssetHandle<const std::vector<char>>> m_Effects{};
+};
@@ -29,6 +29,7 @@ namespace dae
 
 		bool hasMoved{ true };
 		bool hasChangedFov{ true };
+		bool hasChanged{ true }; //Moved or zoomed during the last Update
 
 		Vector3 forward{Vector3::UnitZ};
 		Vector3 up{Vector3::UnitY};
@@ -64,6 +65,8 @@ namespace dae
 			HandleMouseInput(factor * movementSpeed, rotationSpeed, deltaTime);
 
 			//Update Matrices
+			hasChanged = hasMoved || hasChangedFov;
+
 			if (hasMoved)
 			{
 				CalculateViewMatrix();
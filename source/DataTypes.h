@@ -13,4 +13,44 @@ enum class RenderMode
 	ObservedArea,
 	Diffuse,
 	Specular
-};
\ No newline at end of file
+};
+
+enum class ShadingQuality
+{
+	Precise,
+	Fast,
+	LookupTable
+};
+
+enum class PrimitiveTopology
+{
+	TriangleList,
+	TriangleStrip //Cut by restart indices (all ones)
+};
+
+//Width x height of the pixels that share one shading result, adaptive chooses per screen tile
+enum class ShadingRate
+{
+	Rate1x1,
+	Rate1x2,
+	Rate2x1,
+	Rate2x2,
+	Rate4x4,
+	Adaptive
+};
+
+enum class VertexFormat
+{
+	Full,
+	Compressed
+};
+
+//Software debug views of the per pixel counters, drawn in place of the image (see dae::Heatmap)
+enum class HeatmapMode
+{
+	Off,
+	Overdraw,
+	DepthFails,
+	ShadingCost,
+	TileTime
+};
@@ -6,13 +6,16 @@
 #include "Effect.h"
 #include "Texture.h"
 #include <assert.h>
+#include <future>
+#include <mutex>
+#include <unordered_map>
 #include "Camera.h"
 
 //---------------------------
 // Constructor & Destructor
 //---------------------------
 
-Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
+Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat)
 {
 	m_pEffect = LoadEffect(pDevice, assetFile);
 
@@ -20,7 +23,9 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
 	// Techniques								
 	//-----------------------------------------------------
 
-	m_pTechnique = m_pEffect->GetTechniqueByName("DefaultTechnique");
+	//Same shading, the compressed technique decodes the vertices first
+	const bool isCompressed{ vertexFormat == VertexFormat::Compressed };
+	m_pTechnique = m_pEffect->GetTechniqueByName(isCompressed ? "CompressedTechnique" : "DefaultTechnique");
 
 	if (!m_pTechnique->IsValid())
 	{
@@ -31,11 +36,25 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
 	// Matrices								
 	//-----------------------------------------------------
 
-	m_pWorldViewProjectionMatrixVariable = m_pEffect->GetVariableByName("gWorldViewProj")->AsMatrix();
+	m_pViewProjectionMatrixVariable = m_pEffect->GetVariableByName("gViewProj")->AsMatrix();
 
-	if (!m_pWorldViewProjectionMatrixVariable->IsValid())
+	if (!m_pViewProjectionMatrixVariable->IsValid())
 	{
-		std::wcout << L"WorldViewProjection matrix not valid\n";
+		std::wcout << L"ViewProjection matrix not valid\n";
+	}
+
+	m_pPositionOffsetVariable = m_pEffect->GetVariableByName("gPositionOffset")->AsVector();
+
+	if (!m_pPositionOffsetVariable->IsValid())
+	{
+		std::wcout << L"Position offset not valid\n";
+	}
+
+	m_pPositionScaleVariable = m_pEffect->GetVariableByName("gPositionScale")->AsVector();
+
+	if (!m_pPositionScaleVariable->IsValid())
+	{
+		std::wcout << L"Position scale not valid\n";
 	}
 
 	m_pSamplerStateVariable = m_pEffect->GetVariableByName("gSamplerState")->AsSampler();
@@ -56,29 +75,66 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
 	// Vertex Layout								
 	//-----------------------------------------------------
 
-	static constexpr uint32_t numElements{ 4 };
+	static constexpr uint32_t numElements{ 8 };
 	D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
 
 	vertexDesc[0].SemanticName = "POSITION";
-	vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[0].AlignedByteOffset = 0;
 	vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
 	vertexDesc[1].SemanticName = "TEXCOORD";
-	vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-	vertexDesc[1].AlignedByteOffset = 12; //3 x float --- float = 4 bytes
 	vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
 	vertexDesc[2].SemanticName = "NORMAL";
-	vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[2].AlignedByteOffset = 20;
 	vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
 	vertexDesc[3].SemanticName = "TANGENT";
-	vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-	vertexDesc[3].AlignedByteOffset = 32;
 	vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 
+	if (isCompressed)
+	{
+		//dae::CompressedVertex
+		vertexDesc[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM; //w: handedness
+		vertexDesc[0].AlignedByteOffset = 0;
+
+		vertexDesc[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+		vertexDesc[1].AlignedByteOffset = 8; //4 x uint16
+
+		vertexDesc[2].Format = DXGI_FORMAT_R16G16_SNORM; //Octahedral
+		vertexDesc[2].AlignedByteOffset = 12;
+
+		vertexDesc[3].Format = DXGI_FORMAT_R16G16_SNORM; //Octahedral
+		vertexDesc[3].AlignedByteOffset = 16;
+	}
+	else
+	{
+		//Vertex
+		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		vertexDesc[0].AlignedByteOffset = 0;
+
+		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+		vertexDesc[1].AlignedByteOffset = 12; //3 x float --- float = 4 bytes
+
+		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+		vertexDesc[2].AlignedByteOffset = 20;
+
+		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32A32_FLOAT; //w: handedness
+		vertexDesc[3].AlignedByteOffset = 32;
+	}
+
+	//Instance world matrix, one row per element (see Mesh::Render)
+	for (uint32_t row{}; row < 4; ++row)
+	{
+		D3D11_INPUT_ELEMENT_DESC& elementDesc{ vertexDesc[4 + row] };
+
+		elementDesc.SemanticName = "WORLD";
+		elementDesc.SemanticIndex = row;
+		elementDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		elementDesc.InputSlot = 1;
+		elementDesc.AlignedByteOffset = row * 16; //4 x float
+		elementDesc.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+		elementDesc.InstanceDataStepRate = 1;
+	}
+
 	//-----------------------------------------------------
 	// Input Layout								
 	//-----------------------------------------------------
@@ -108,11 +164,21 @@ Effect::~Effect()
 		m_pSamplerStateVariable->Release();
 	}
 	
+	if (m_pPositionScaleVariable)
+	{
+		m_pPositionScaleVariable->Release();
+	}
+
+	if (m_pPositionOffsetVariable)
+	{
+		m_pPositionOffsetVariable->Release();
+	}
+
 	//Matrices
 
-	if (m_pWorldViewProjectionMatrixVariable)
+	if (m_pViewProjectionMatrixVariable)
 	{
-		m_pWorldViewProjectionMatrixVariable->Release();
+		m_pViewProjectionMatrixVariable->Release();
 	}
 
 	if (m_pTechnique)
@@ -145,11 +211,38 @@ ID3D11InputLayout* Effect::GetInputLayout() const
 	return m_pInputLayout;
 }
 
-void Effect::SetMatrices(dae::Camera* pCamera, const dae::Matrix& worldMatrix)
+void Effect::SetMatrices(dae::Camera* pCamera)
+{
+	m_ViewProjectionMatrix = pCamera->viewMatrix * pCamera->projectionMatrix;
+
+	m_pViewProjectionMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&(m_ViewProjectionMatrix)));
+}
+
+void Effect::SetWorldMatrix(const dae::Matrix& worldMatrix)
+{
+	//Software only, DirectX gets the world matrices from the instance buffer
+	m_WorldMatrix = worldMatrix;
+	m_WorldViewProjectionMatrix = worldMatrix * m_ViewProjectionMatrix;
+}
+
+const dae::Matrix& Effect::GetViewProjectionMatrix() const
+{
+	return m_ViewProjectionMatrix;
+}
+
+void Effect::SetPositionQuantization(const dae::PositionQuantization& positionQuantization)
 {
-	m_WorldViewProjectionMatrix = worldMatrix * pCamera->viewMatrix * pCamera->projectionMatrix;
+	m_PositionQuantization = positionQuantization;
+
+	//Effect vectors are set as 4 floats
+	const dae::Vector3& offset{ m_PositionQuantization.offset };
+	const dae::Vector3& scale{ m_PositionQuantization.scale };
 
-	m_pWorldViewProjectionMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&(m_WorldViewProjectionMatrix)));
+	const float offsetVector[4]{ offset.x, offset.y, offset.z, 0.f };
+	const float scaleVector[4]{ scale.x, scale.y, scale.z, 0.f };
+
+	m_pPositionOffsetVariable->SetFloatVector(offsetVector);
+	m_pPositionScaleVariable->SetFloatVector(scaleVector);
 }
 
 void Effect::SetSamplerState(ID3D11SamplerState* pSamplerState)
@@ -164,11 +257,23 @@ void Effect::SetRasterizerState(ID3D11RasterizerState* pRasterizerState)
 	if (FAILED(hr)) std::wcout << L"Failed to change rasterizer state\n";
 }
 
-ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
+std::shared_ptr<const std::vector<char>> Effect::CompileEffect(const std::wstring& assetFile)
 {
-	HRESULT result;
-	ID3D10Blob* pErrorBlob{ nullptr };
-	ID3DX11Effect* pEffect;
+	using ByteCode = std::shared_ptr<const std::vector<char>>;
+
+	static std::mutex mutex{};
+	static std::unordered_map<std::wstring, std::shared_future<ByteCode>> byteCodes{};
+
+	//The first caller compiles, everyone else waits for its result
+	std::promise<ByteCode> promise{};
+	{
+		const std::lock_guard<std::mutex> lock{ mutex };
+
+		const auto it{ byteCodes.find(assetFile) };
+		if (it != byteCodes.end()) return it->second.get();
+
+		byteCodes.emplace(assetFile, promise.get_future().share());
+	}
 
 	DWORD shaderFlags{ 0 };
 
@@ -177,34 +282,65 @@ ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& ass
 	shaderFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
-	result = D3DX11CompileEffectFromFile(assetFile.c_str(), nullptr, nullptr, shaderFlags, 0, pDevice, &pEffect, &pErrorBlob);
+	ID3DBlob* pByteCodeBlob{ nullptr };
+	ID3DBlob* pErrorBlob{ nullptr };
 
-	if (FAILED(result))
+	const HRESULT result{ D3DCompileFromFile(assetFile.c_str(), nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, nullptr, "fx_5_0", shaderFlags, 0, &pByteCodeBlob, &pErrorBlob) };
+
+	ByteCode byteCode{};
+
+	if (SUCCEEDED(result))
 	{
-		if (pErrorBlob != nullptr)
+		const char* pBegin{ static_cast<const char*>(pByteCodeBlob->GetBufferPointer()) };
+		byteCode = std::make_shared<const std::vector<char>>(pBegin, pBegin + pByteCodeBlob->GetBufferSize());
+	}
+	else if (pErrorBlob != nullptr)
+	{
+		const char* pErrors = static_cast<char*>(pErrorBlob->GetBufferPointer());
+
+		std::wstringstream ss;
+		for (unsigned int i{}; i < pErrorBlob->GetBufferSize(); ++i)
 		{
-			const char* pErrors = static_cast<char*>(pErrorBlob->GetBufferPointer());
+			ss << pErrors[i];
+		}
 
-			std::wstringstream ss;
-			for (unsigned int i{}; i < pErrorBlob->GetBufferSize(); ++i)
-			{
-				ss << pErrors[i];
-			}
+		OutputDebugStringW(ss.str().c_str());
+		std::wcout << ss.str() << std::endl;
+	}
+	else
+	{
+		std::wstringstream ss;
+		ss << "EffectLoader: Failed to CreateEffectFromFile!\nPath: " << assetFile;
+		std::wcout << ss.str() << std::endl;
+	}
 
-			OutputDebugStringW(ss.str().c_str());
-			pErrorBlob->Release();
-			pErrorBlob = nullptr;
+	if (pByteCodeBlob)
+	{
+		pByteCodeBlob->Release();
+	}
 
-			std::wcout << ss.str() << std::endl;
-		}
-		else
-		{
-			std::wstringstream ss;
-			ss << "EffectLoader: Failed to CreateEffectFromFile!\nPath: " << assetFile;
-			std::wcout << ss.str() << std::endl;
+	if (pErrorBlob)
+	{
+		pErrorBlob->Release();
+	}
 
-			return nullptr;
-		}
+	promise.set_value(byteCode);
+	return byteCode;
+}
+
+ID3DX11Effect* Effect::LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
+{
+	//Compiling is the slow part, it only happens once per file
+	const std::shared_ptr<const std::vector<char>> pByteCode{ CompileEffect(assetFile) };
+	if (!pByteCode) return nullptr;
+
+	ID3DX11Effect* pEffect{ nullptr };
+
+	const HRESULT result{ D3DX11CreateEffectFromMemory(pByteCode->data(), pByteCode->size(), 0, pDevice, &pEffect) };
+	if (FAILED(result))
+	{
+		std::wcout << L"EffectLoader: Failed to create effect\nPath: " << assetFile << std::endl;
+		return nullptr;
 	}
 
 	return pEffect;
@@ -4,6 +4,7 @@
 // Include Files
 //-----------------------------------------------------
 #include "DataTypes.h"
+#include "VertexCompression.h"
 class Texture;
 namespace dae
 {
@@ -17,7 +18,7 @@ class Effect
 {
 public:
 	Effect() = default;
-	Effect(ID3D11Device* pDevice, const std::wstring& assetFile);
+	Effect(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat);
 	virtual ~Effect();
 
 	// -------------------------
@@ -35,10 +36,18 @@ public:
 	ID3DX11EffectTechnique* GetTechnique() const;
 	ID3D11InputLayout* GetInputLayout() const;
 
-	virtual void SetMatrices(dae::Camera* pCamera, const dae::Matrix& worldMatrix);
+	virtual void SetMatrices(dae::Camera* pCamera);
+	void SetWorldMatrix(const dae::Matrix& worldMatrix);
+	const dae::Matrix& GetViewProjectionMatrix() const;
 	void SetSamplerState(ID3D11SamplerState* pSamplerState);
 	void SetRasterizerState(ID3D11RasterizerState* pRasterizerState);
 
+	//Decodes the positions of compressed vertices, in both rasterizers
+	void SetPositionQuantization(const dae::PositionQuantization& positionQuantization);
+
+	//Compiles every file once, later calls wait for or return the cached bytecode. Thread safe, nullptr when compiling failed
+	static std::shared_ptr<const std::vector<char>> CompileEffect(const std::wstring& assetFile);
+
 protected:
 	//-------------------------------------------------
 	// Private member functions								
@@ -52,13 +61,22 @@ protected:
 	ID3DX11EffectTechnique* m_pTechnique;
 	ID3D11InputLayout* m_pInputLayout;
 
-	ID3DX11EffectMatrixVariable* m_pWorldViewProjectionMatrixVariable;
+	ID3DX11EffectMatrixVariable* m_pViewProjectionMatrixVariable;
+
+	ID3DX11EffectVectorVariable* m_pPositionOffsetVariable;
+	ID3DX11EffectVectorVariable* m_pPositionScaleVariable;
 
 	ID3DX11EffectSamplerVariable* m_pSamplerStateVariable;
 	ID3DX11EffectRasterizerVariable* m_pRasterizerStateVariable;
 
+	dae::Matrix m_ViewProjectionMatrix{};
+
+	//Software, the world matrix of the instance that is being rendered
+	dae::Matrix m_WorldMatrix{};
 	dae::Matrix m_WorldViewProjectionMatrix{};
 
+	dae::PositionQuantization m_PositionQuantization{};
+
 	//Shading
 	const dae::Vector3 m_LightDirection{ 0.577f,-0.577f,0.577f };
 	const float m_LightIntensity{ 7.f };
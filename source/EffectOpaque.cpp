@@ -7,25 +7,19 @@
 #include "Texture.h"
 #include "Camera.h"
 #include "Mesh.h"
+#include "FastMath.h"
 
 //---------------------------
 // Constructor & Destructor
 //---------------------------
 
-EffectOpaque::EffectOpaque(ID3D11Device* pDevice, const std::wstring& assetFile)
-	:Effect(pDevice, assetFile)
+EffectOpaque::EffectOpaque(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat)
+	:Effect(pDevice, assetFile, vertexFormat)
 {
 	//-----------------------------------------------------
 	// Matrices								
 	//-----------------------------------------------------
 
-	m_pWorldMatrixVariable = m_pEffect->GetVariableByName("gWorld")->AsMatrix();
-
-	if (!m_pWorldMatrixVariable->IsValid())
-	{
-		std::wcout << L"World matrix not valid\n";
-	}
-
 	m_pViewInverseMatrixVariable = m_pEffect->GetVariableByName("gViewInverse")->AsMatrix();
 
 	if (!m_pViewInverseMatrixVariable->IsValid())
@@ -64,6 +58,12 @@ EffectOpaque::EffectOpaque(ID3D11Device* pDevice, const std::wstring& assetFile)
 	{
 		std::wcout << L"Glossiness map not valid\n";
 	}
+
+	//-----------------------------------------------------
+	// Software shading								
+	//-----------------------------------------------------
+
+	CreateSpecularLookupTable();
 }
 
 EffectOpaque::~EffectOpaque()
@@ -96,20 +96,44 @@ EffectOpaque::~EffectOpaque()
 	{
 		m_pViewInverseMatrixVariable->Release();
 	}
-
-	if (m_pWorldMatrixVariable)
-	{
-		m_pWorldMatrixVariable->Release();
-	}
 }
 
-void EffectOpaque::VertexTransformationFunction(const std::vector<Vertex>& vertices, std::vector<VertexOut>& verticesOut, const std::vector<uint32_t>& indices)
+template<typename VertexType>
+void EffectOpaque::VertexTransformationFunction(const std::vector<VertexType>& vertices, std::span<VertexOut> verticesOut, uint32_t nrVertices)
 {
 	dae::Vector4 position{};
 
-	for (size_t index{}; index < vertices.size(); ++index)
+	for (uint32_t index{}; index < nrVertices; ++index)
 	{
-		position = { vertices[index].position.x,vertices[index].position.y,vertices[index].position.z,0.f };
+		//Decode
+		dae::Vector3 vertexPosition{};
+		dae::Vector3 normal{};
+		dae::Vector3 tangent{};
+
+		if constexpr (std::is_same_v<VertexType, dae::CompressedVertex>)
+		{
+			const dae::CompressedVertex& vertex{ vertices[index] };
+
+			vertexPosition = dae::VertexCompression::DecodePosition(vertex, m_PositionQuantization);
+			normal = dae::VertexCompression::DecodeOctahedral(vertex.normal);
+			tangent = dae::VertexCompression::DecodeOctahedral(vertex.tangent);
+
+			verticesOut[index].uv = dae::VertexCompression::DecodeUV(vertex);
+			verticesOut[index].handedness = dae::VertexCompression::DecodeHandedness(vertex);
+		}
+		else
+		{
+			const Vertex& vertex{ vertices[index] };
+
+			vertexPosition = vertex.position;
+			normal = vertex.normal;
+			tangent = vertex.tangent;
+
+			verticesOut[index].uv = vertex.uv;
+			verticesOut[index].handedness = vertex.handedness;
+		}
+
+		position = { vertexPosition.x,vertexPosition.y,vertexPosition.z,0.f };
 		verticesOut[index].position = m_WorldViewProjectionMatrix.TransformPoint(position);
 
 		const float inverseW{ 1.f / verticesOut[index].position.w };
@@ -121,72 +145,116 @@ void EffectOpaque::VertexTransformationFunction(const std::vector<Vertex>& verti
 		verticesOut[index].position.w = inverseW;
 
 		//Normals
-		verticesOut[index].normal = m_WorldMatrix.TransformVector(vertices[index].normal).Normalized();
-		verticesOut[index].tangent = m_WorldMatrix.TransformVector(vertices[index].tangent).Normalized();
+		verticesOut[index].normal = m_WorldMatrix.TransformVector(normal).Normalized();
+		verticesOut[index].tangent = m_WorldMatrix.TransformVector(tangent).Normalized();
 
 		//View
-		verticesOut[index].viewDirection = m_WorldMatrix.TransformPoint(vertices[index].position) - m_ViewInverseMatrix.GetTranslation();
+		verticesOut[index].viewDirection = m_WorldMatrix.TransformPoint(vertexPosition) - m_ViewInverseMatrix.GetTranslation();
 	}
 }
 
-void EffectOpaque::PixelShading(const VertexOut& v, int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, bool useNormalMap, RenderMode renderMode) const
+template void EffectOpaque::VertexTransformationFunction<Vertex>(const std::vector<Vertex>&, std::span<VertexOut>, uint32_t);
+template void EffectOpaque::VertexTransformationFunction<dae::CompressedVertex>(const std::vector<dae::CompressedVertex>&, std::span<VertexOut>, uint32_t);
+
+template<bool useNormalMap, RenderMode renderMode, ShadingQuality shadingQuality>
+uint32_t EffectOpaque::PixelShading(const VertexOut& v, const SDL_PixelFormat* pFormat) const
 {
 	dae::ColorRGB finalColor{};
 
-	const dae::Vector3 binominal{ dae::Vector3::Cross(v.normal,v.tangent) };
-	const dae::Matrix tangentSpaceAxis{ v.tangent,binominal,v.normal,dae::Vector3::Zero };
+	dae::Vector3 sampledNormal{ v.normal };
+
+	if constexpr (useNormalMap)
+	{
+		const dae::Vector3 binominal{ v.handedness * dae::Vector3::Cross(v.normal,v.tangent) };
+		const dae::Matrix tangentSpaceAxis{ v.tangent,binominal,v.normal,dae::Vector3::Zero };
+
+		const dae::ColorRGB normalMapSample{ m_pNormalMap->SampleRGB(v.uv) };
 
-	const dae::ColorRGB normalMapSample{ m_pNormalMap->SampleRGB(v.uv) };
+		sampledNormal = { 2.f * normalMapSample.r - 1.f,2.f * normalMapSample.g - 1.f,2.f * normalMapSample.b - 1.f };
+		sampledNormal = tangentSpaceAxis.TransformVector(sampledNormal);
 
-	dae::Vector3 sampledNormal{ 2.f * normalMapSample.r - 1.f,2.f * normalMapSample.g - 1.f,2.f * normalMapSample.b - 1.f };
-	sampledNormal = (useNormalMap ? tangentSpaceAxis.TransformVector(sampledNormal).Normalized() : v.normal);
+		if constexpr (shadingQuality == ShadingQuality::Fast)
+		{
+			sampledNormal = dae::FastMath::Normalized(sampledNormal);
+		}
+		else
+		{
+			sampledNormal.Normalize();
+		}
+	}
 
 	const float observedArea{ dae::Vector3::Dot(sampledNormal,-m_LightDirection) };
 
 	if (observedArea > 0.f)
 	{
-		const dae::ColorRGB diffuse{ (m_LightIntensity * m_pDiffuseMap->SampleRGB(v.uv)) / static_cast<float>(M_PI) };
-
-		dae::ColorRGB specular{ m_pSpecularMap->SampleRGB(v.uv) * Phong(1.f,m_Shininess * m_pGlossinessMap->SampleRGB(v.uv).r,-m_LightDirection,v.viewDirection,sampledNormal) };
-
-		specular.r = std::clamp(specular.r, 0.f, 1.f);
-		specular.g = std::clamp(specular.g, 0.f, 1.f);
-		specular.b = std::clamp(specular.b, 0.f, 1.f);
-
-		switch (renderMode)
+		if constexpr (renderMode == RenderMode::ObservedArea)
 		{
-		case RenderMode::Combined:
-			finalColor = observedArea * (diffuse + specular + m_Ambient);
-			break;
-		case RenderMode::ObservedArea:
 			finalColor = { observedArea,observedArea,observedArea };
-			break;
-		case RenderMode::Diffuse:
-			finalColor = observedArea * diffuse;
-			break;
-		case RenderMode::Specular:
-			finalColor = observedArea * specular;
-			break;
+		}
+		else
+		{
+			dae::ColorRGB diffuse{};
+			dae::ColorRGB specular{};
+
+			if constexpr (renderMode != RenderMode::Specular)
+			{
+				diffuse = (m_LightIntensity * m_pDiffuseMap->SampleRGB(v.uv)) / static_cast<float>(M_PI);
+			}
+
+			if constexpr (renderMode != RenderMode::Diffuse)
+			{
+				specular = m_pSpecularMap->SampleRGB(v.uv) * Phong<shadingQuality>(1.f, m_Shininess * m_pGlossinessMap->SampleRGB(v.uv).r, -m_LightDirection, v.viewDirection, sampledNormal);
+
+				specular.r = std::clamp(specular.r, 0.f, 1.f);
+				specular.g = std::clamp(specular.g, 0.f, 1.f);
+				specular.b = std::clamp(specular.b, 0.f, 1.f);
+			}
+
+			if constexpr (renderMode == RenderMode::Combined)
+			{
+				finalColor = observedArea * (diffuse + specular + m_Ambient);
+			}
+			else if constexpr (renderMode == RenderMode::Diffuse)
+			{
+				finalColor = observedArea * diffuse;
+			}
+			else
+			{
+				finalColor = observedArea * specular;
+			}
 		}
 	}
 
-	//Update Color in Buffer
 	finalColor.MaxToOne();
 
-	pBackBufferPixels[static_cast<int>(v.position.x) + (static_cast<int>(v.position.y) * width)] = SDL_MapRGB(pBackBuffer->format,
+	return SDL_MapRGB(pFormat,
 		static_cast<uint8_t>(finalColor.r * 255),
 		static_cast<uint8_t>(finalColor.g * 255),
 		static_cast<uint8_t>(finalColor.b * 255));
 }
 
-void EffectOpaque::SetMatrices(dae::Camera* pCamera, const dae::Matrix& worldMatrix)
+//Every permutation MeshOpaque can select
+#define INSTANTIATE_PIXEL_SHADING(useNormalMap, shadingQuality) \
+	template uint32_t EffectOpaque::PixelShading<useNormalMap, RenderMode::Combined, shadingQuality>(const VertexOut&, const SDL_PixelFormat*) const; \
+	template uint32_t EffectOpaque::PixelShading<useNormalMap, RenderMode::ObservedArea, shadingQuality>(const VertexOut&, const SDL_PixelFormat*) const; \
+	template uint32_t EffectOpaque::PixelShading<useNormalMap, RenderMode::Diffuse, shadingQuality>(const VertexOut&, const SDL_PixelFormat*) const; \
+	template uint32_t EffectOpaque::PixelShading<useNormalMap, RenderMode::Specular, shadingQuality>(const VertexOut&, const SDL_PixelFormat*) const;
+
+INSTANTIATE_PIXEL_SHADING(false, ShadingQuality::Precise)
+INSTANTIATE_PIXEL_SHADING(true, ShadingQuality::Precise)
+INSTANTIATE_PIXEL_SHADING(false, ShadingQuality::Fast)
+INSTANTIATE_PIXEL_SHADING(true, ShadingQuality::Fast)
+INSTANTIATE_PIXEL_SHADING(false, ShadingQuality::LookupTable)
+INSTANTIATE_PIXEL_SHADING(true, ShadingQuality::LookupTable)
+
+#undef INSTANTIATE_PIXEL_SHADING
+
+void EffectOpaque::SetMatrices(dae::Camera* pCamera)
 {
-	Effect::SetMatrices(pCamera, worldMatrix);
+	Effect::SetMatrices(pCamera);
 
 	m_ViewInverseMatrix = pCamera->invViewMatrix;
-	m_WorldMatrix = worldMatrix;
 
-	m_pWorldMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&(m_WorldMatrix)));
 	m_pViewInverseMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&(m_ViewInverseMatrix)));
 }
 
@@ -230,8 +298,64 @@ void EffectOpaque::SetGlossinessMap(Texture* pGlossinessTexture)
 	std::wcout << L"Glossines map: OK\n";
 }
 
+void EffectOpaque::SetShadingQuality(ShadingQuality shadingQuality)
+{
+	m_ShadingQuality = shadingQuality;
+}
+
+ShadingQuality EffectOpaque::GetShadingQuality() const
+{
+	return m_ShadingQuality;
+}
+
+template<ShadingQuality shadingQuality>
 float EffectOpaque::Phong(float ks, float exp, const dae::Vector3& l, const dae::Vector3& v, const dae::Vector3 n) const
 {		
-	return powf(std::max(dae::Vector3::Dot(l - (2.f * std::max(dae::Vector3::Dot(n, l), 0.f) * n), v), 0.f), exp);
+	const float cosAngle{ std::max(dae::Vector3::Dot(l - (2.f * std::max(dae::Vector3::Dot(n, l), 0.f) * n), v), 0.f) };
+
+	if constexpr (shadingQuality == ShadingQuality::Fast)
+	{
+		return dae::FastMath::Pow(cosAngle, exp);
+	}
+	else if constexpr (shadingQuality == ShadingQuality::LookupTable)
+	{
+		return SampleSpecularLookupTable(exp, cosAngle);
+	}
+	else
+	{
+		return powf(cosAngle, exp);
+	}
+}
+
+void EffectOpaque::CreateSpecularLookupTable()
+{
+	//One extra column so the interpolation never reads past the end of a row
+	constexpr int nrColumns{ m_NrSpecularAngles + 1 };
+	m_SpecularLookupTable.resize(static_cast<size_t>(m_NrSpecularExponents) * nrColumns);
+
+	for (int row{}; row < m_NrSpecularExponents; ++row)
+	{
+		const float exp{ m_Shininess * row / static_cast<float>(m_NrSpecularExponents - 1) };
+
+		for (int column{}; column < nrColumns; ++column)
+		{
+			const float cosAngle{ std::min(column / static_cast<float>(m_NrSpecularAngles - 1), 1.f) };
+			m_SpecularLookupTable[row * nrColumns + column] = powf(cosAngle, exp);
+		}
+	}
+}
+
+float EffectOpaque::SampleSpecularLookupTable(float exp, float cosAngle) const
+{
+	constexpr int nrColumns{ m_NrSpecularAngles + 1 };
+
+	//exp = m_Shininess * gloss, gloss = texel / 255
+	const int row{ std::clamp(static_cast<int>(exp * ((m_NrSpecularExponents - 1) / m_Shininess) + 0.5f), 0, m_NrSpecularExponents - 1) };
+
+	const float column{ std::min(cosAngle, 1.f) * (m_NrSpecularAngles - 1) };
+	const int leftColumn{ static_cast<int>(column) };
+
+	const float* pRow{ &m_SpecularLookupTable[row * nrColumns] };
+	return dae::Lerpf(pRow[leftColumn], pRow[leftColumn + 1], column - leftColumn);
 }
 
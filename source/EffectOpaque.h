@@ -3,6 +3,7 @@
 // Include Files
 //-----------------------------------------------------
 #include "Effect.h"
+#include <span>
 struct Vertex;
 struct VertexOut;
 
@@ -13,7 +14,7 @@ struct VertexOut;
 class EffectOpaque final : public Effect
 {
 public:
-	EffectOpaque(ID3D11Device* pDevice, const std::wstring& assetFile);
+	EffectOpaque(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat);
 	~EffectOpaque();
 
 	//-------------------------------------------------
@@ -28,24 +29,35 @@ public:
 	//-------------------------------------------------
 	// Member functions						
 	//-------------------------------------------------
-	void VertexTransformationFunction(const std::vector<Vertex>& vertices, std::vector<VertexOut>& verticesOut, const std::vector<uint32_t>& indices);
-	void PixelShading(const VertexOut& v, int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, bool useNormalMap, RenderMode renderMode) const;
+	//Instantiated for Vertex and dae::CompressedVertex in EffectOpaque.cpp
+	template<typename VertexType>
+	void VertexTransformationFunction(const std::vector<VertexType>& vertices, std::span<VertexOut> verticesOut, uint32_t nrVertices);
 
-	virtual void SetMatrices(dae::Camera* pCamera, const dae::Matrix& worldMatrix) override;
+	//Instantiated for every combination in EffectOpaque.cpp, returns the color in the format of the back buffer
+	template<bool useNormalMap, RenderMode renderMode, ShadingQuality shadingQuality>
+	uint32_t PixelShading(const VertexOut& v, const SDL_PixelFormat* pFormat) const;
+
+	virtual void SetMatrices(dae::Camera* pCamera) override;
 
 	void SetDiffuseMap(Texture* pDiffuseTexture);
 	void SetNormalMap(Texture* pNormalTexture);
 	void SetSpecularMap(Texture* pSpecularTexture);
 	void SetGlossinessMap(Texture* pGlossinessTexture);
 
+	void SetShadingQuality(ShadingQuality shadingQuality);
+	ShadingQuality GetShadingQuality() const;
+
 private:
+	template<ShadingQuality shadingQuality>
 	float Phong(float ks, float exp, const dae::Vector3& l, const dae::Vector3& v, const dae::Vector3 n) const;
 
+	void CreateSpecularLookupTable();
+	float SampleSpecularLookupTable(float exp, float cosAngle) const;
+
 	//-------------------------------------------------
 	// Datamembers								
 	//-------------------------------------------------
 	ID3DX11EffectMatrixVariable* m_pViewInverseMatrixVariable;
-	ID3DX11EffectMatrixVariable* m_pWorldMatrixVariable;
 
 	ID3DX11EffectShaderResourceVariable* m_pDiffuseMapVariable;
 	ID3DX11EffectShaderResourceVariable* m_pNormalMapVariable;
@@ -58,7 +70,15 @@ private:
 	Texture* m_pGlossinessMap{};
 
 	dae::Matrix m_ViewInverseMatrix{};
-	dae::Matrix m_WorldMatrix{};
+
+	ShadingQuality m_ShadingQuality{ ShadingQuality::Precise };
+
+	//Specular lookup table, the glossiness is an 8 bit texel so there are only 256 different exponents
+	//Rows: exponent (m_Shininess * gloss), columns: cos angle in [0, 1], sampled linearly between columns
+	//Absolute error < 4e-3, except in the first column interval for exponents close to 0 (where powf is nearly a step function)
+	static constexpr int m_NrSpecularExponents{ 256 };
+	static constexpr int m_NrSpecularAngles{ 256 };
+	std::vector<float> m_SpecularLookupTable{};
 };
 
 
@@ -13,17 +13,9 @@
 // Constructor & Destructor
 //---------------------------
 
-EffectTransparent::EffectTransparent(ID3D11Device* pDevice, const std::wstring& assetFile)
-	:Effect(pDevice, assetFile)
+EffectTransparent::EffectTransparent(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat)
+	:Effect(pDevice, assetFile, vertexFormat)
 {
-	//-----------------------------------------------------
-	// Transparency								
-	//-----------------------------------------------------
-
-	m_pRed = new Uint8;
-	m_pGreen = new Uint8;
-	m_pBlue = new Uint8;
-
 	//-----------------------------------------------------
 	// Maps								
 	//-----------------------------------------------------
@@ -44,21 +36,30 @@ EffectTransparent::~EffectTransparent()
 	{
 		m_pDiffuseMapVariable->Release();
 	}
-
-	//Transparency
-
-	delete m_pRed;
-	delete m_pGreen;
-	delete m_pBlue;
 }
 
-void EffectTransparent::VertexTransformationFunction(const std::vector<Vertex>& vertices, std::vector<VertexOut>& verticesOut, const std::vector<uint32_t>& indices)
+template<typename VertexType>
+void EffectTransparent::VertexTransformationFunction(const std::vector<VertexType>& vertices, std::span<VertexOut> verticesOut, uint32_t nrVertices)
 {
 	dae::Vector4 position{};
 
-	for (size_t index{}; index < vertices.size(); ++index)
+	for (uint32_t index{}; index < nrVertices; ++index)
 	{
-		position = { vertices[index].position.x,vertices[index].position.y,vertices[index].position.z,0.f };
+		//Decode
+		dae::Vector3 vertexPosition{};
+
+		if constexpr (std::is_same_v<VertexType, dae::CompressedVertex>)
+		{
+			vertexPosition = dae::VertexCompression::DecodePosition(vertices[index], m_PositionQuantization);
+			verticesOut[index].uv = dae::VertexCompression::DecodeUV(vertices[index]);
+		}
+		else
+		{
+			vertexPosition = vertices[index].position;
+			verticesOut[index].uv = vertices[index].uv;
+		}
+
+		position = { vertexPosition.x,vertexPosition.y,vertexPosition.z,0.f };
 		verticesOut[index].position = m_WorldViewProjectionMatrix.TransformPoint(position);
 
 		const float inverseW{ 1.f / verticesOut[index].position.w };
@@ -71,13 +72,22 @@ void EffectTransparent::VertexTransformationFunction(const std::vector<Vertex>&
 	}
 }
 
-void EffectTransparent::PixelShading(const VertexOut& v, int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels) const
+template void EffectTransparent::VertexTransformationFunction<Vertex>(const std::vector<Vertex>&, std::span<VertexOut>, uint32_t);
+template void EffectTransparent::VertexTransformationFunction<dae::CompressedVertex>(const std::vector<dae::CompressedVertex>&, std::span<VertexOut>, uint32_t);
+
+dae::Vector4 EffectTransparent::PixelShading(const VertexOut& v) const
 {
 	//Sample the cololr from texture
-	dae::Vector4 sample{ m_pDiffuseMap->SampleRGBA(v.uv) };
+	return m_pDiffuseMap->SampleRGBA(v.uv);
+}
 
+uint32_t EffectTransparent::Blend(const dae::Vector4& sample, uint32_t destination, const SDL_PixelFormat* pFormat) const
+{
 	//Sample the color from screen
-	SDL_GetRGB(pBackBufferPixels[static_cast<int>(v.position.x) + (static_cast<int>(v.position.y) * width)], pBackBuffer->format, m_pRed, m_pGreen, m_pBlue);
+	Uint8 red{};
+	Uint8 green{};
+	Uint8 blue{};
+	SDL_GetRGB(destination, pFormat, &red, &green, &blue);
 
 	//Calculate blended color
 	const float inverseAlpha{ 1.f - sample.w };
@@ -85,15 +95,15 @@ void EffectTransparent::PixelShading(const VertexOut& v, int width, int height,
 
 	dae::ColorRGB finalColor
 	{ 
-		sample.x * sample.w + *m_pRed * inverseAlpha * division,
-		sample.y * sample.w + *m_pGreen * inverseAlpha * division,
-		sample.z * sample.w + *m_pBlue * inverseAlpha * division
+		sample.x * sample.w + red * inverseAlpha * division,
+		sample.y * sample.w + green * inverseAlpha * division,
+		sample.z * sample.w + blue * inverseAlpha * division
 	};
 
 	//Set color
 	finalColor.MaxToOne();
 
-	pBackBufferPixels[static_cast<int>(v.position.x) + (static_cast<int>(v.position.y) * width)] = SDL_MapRGB(pBackBuffer->format,
+	return SDL_MapRGB(pFormat,
 		static_cast<uint8_t>(finalColor.r * 255.f),
 		static_cast<uint8_t>(finalColor.g * 255.f),
 		static_cast<uint8_t>(finalColor.b * 255.f));
@@ -3,6 +3,7 @@
 // Include Files
 //-----------------------------------------------------
 #include "Effect.h"
+#include <span>
 struct Vertex;
 struct VertexOut;
 
@@ -13,7 +14,7 @@ struct VertexOut;
 class EffectTransparent final : public Effect
 {
 public:
-	EffectTransparent(ID3D11Device* pDevice, const std::wstring& assetFile);
+	EffectTransparent(ID3D11Device* pDevice, const std::wstring& assetFile, VertexFormat vertexFormat);
 	~EffectTransparent();
 
 	// -------------------------
@@ -27,8 +28,12 @@ public:
 	//-------------------------------------------------
 	// Member functions						
 	//-------------------------------------------------
-	void VertexTransformationFunction(const std::vector<Vertex>& vertices, std::vector<VertexOut>& verticesOut, const std::vector<uint32_t>& indices);
-	void PixelShading(const VertexOut& v, int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels) const;
+	//Instantiated for Vertex and dae::CompressedVertex in EffectTransparent.cpp
+	template<typename VertexType>
+	void VertexTransformationFunction(const std::vector<VertexType>& vertices, std::span<VertexOut> verticesOut, uint32_t nrVertices);
+	//Sampled once per pixel, blended into every sample it covers
+	dae::Vector4 PixelShading(const VertexOut& v) const;
+	uint32_t Blend(const dae::Vector4& sample, uint32_t destination, const SDL_PixelFormat* pFormat) const;
 
 	void SetDiffuseMap(Texture* pDiffuseTexture);
 
@@ -42,11 +47,6 @@ private:
 	Texture* m_pDiffuseMap{};
 
 	//Transparency
-
-	Uint8* m_pRed{};
-	Uint8* m_pGreen{};
-	Uint8* m_pBlue{};
-
 	const float m_BlendFactor{ 0.9f };
 };
 
@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include "Vector3.h"
+
+namespace dae
+{
+	//Branch free approximations for the software shading path.
+	//Only bit casts, multiplies and adds, so loops over them can be vectorized by the compiler.
+	namespace FastMath
+	{
+		//Absolute error < 2.1e-5 for normal, positive x (x <= 0 and denormals are not handled)
+		inline float Log2(float x)
+		{
+			const uint32_t bits{ std::bit_cast<uint32_t>(x) };
+
+			const float exponent{ static_cast<float>(static_cast<int>(bits >> 23) - 127) };
+			const float m{ std::bit_cast<float>((bits & 0x007FFFFF) | 0x3F800000) - 1.f }; //Mantissa - 1, in [0, 1)
+
+			//Least squares fit of log2(1 + m)
+			const float polynomial{ m * (1.4418799f + m * (-0.7088652f + m * (0.41524556f + m * (-0.19351652f + m * 0.04526829f)))) };
+
+			return exponent + polynomial;
+		}
+
+		//Relative error < 7e-6, x is clamped to [-126, 126]
+		inline float Exp2(float x)
+		{
+			x = std::clamp(x, -126.f, 126.f);
+
+			const float floored{ std::floor(x) };
+			const float f{ x - floored }; //Fraction, in [0, 1)
+
+			//Least squares fit of 2^f
+			const float polynomial{ 1.0000036f + f * (0.69296956f + f * (0.24162132f + f * (0.05171774f + f * 0.01368398f))) };
+
+			const uint32_t exponentBits{ static_cast<uint32_t>(static_cast<int>(floored) + 127) << 23 };
+			return std::bit_cast<float>(exponentBits) * polynomial;
+		}
+
+		//exp2(exponent * log2(base)), relative error < 1.5e-5 * |exponent| + 7e-6 for base > 0.
+		//base <= 0 returns 0 (1 when the exponent is 0), matching powf for the clamped dot products used in shading
+		inline float Pow(float base, float exponent)
+		{
+			if (base <= 0.f) return exponent == 0.f ? 1.f : 0.f;
+
+			return Exp2(exponent * Log2(base));
+		}
+
+		//Bit trick estimate refined with one Newton-Raphson step, relative error < 1.8e-3
+		inline float Rsqrt(float x)
+		{
+			const float estimate{ std::bit_cast<float>(0x5F375A86u - (std::bit_cast<uint32_t>(x) >> 1)) };
+
+			return estimate * (1.5f - 0.5f * x * estimate * estimate);
+		}
+
+		//Length of the result is 1 within 1.8e-3, the zero vector is returned unchanged
+		inline Vector3 Normalized(const Vector3& v)
+		{
+			const float sqrMagnitude{ v.x * v.x + v.y * v.y + v.z * v.z };
+			if (sqrMagnitude == 0.f) return v;
+
+			const float inverseMagnitude{ Rsqrt(sqrMagnitude) };
+			return { v.x * inverseMagnitude, v.y * inverseMagnitude, v.z * inverseMagnitude };
+		}
+	}
+}
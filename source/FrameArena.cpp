@@ -0,0 +1,86 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "FrameArena.h"
+
+namespace dae
+{
+	//---------------------------
+	// Constructor & Destructor
+	//---------------------------
+
+	FrameArena::FrameArena(size_t capacity)
+	{
+		m_Blocks.push_back({ std::unique_ptr<std::byte[]>{ new std::byte[capacity] }, capacity });
+	}
+
+	//---------------------------
+	// Member functions
+	//---------------------------
+
+	void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		const Block* pBlock{ &m_Blocks.back() };
+		uintptr_t begin{ reinterpret_cast<uintptr_t>(pBlock->pMemory.get()) };
+		uintptr_t address{ (begin + m_Offset + alignment - 1) & ~(alignment - 1) };
+
+		//Doesn't fit, the next block is at least as big as all blocks together. The rest of this block is unused until Reset
+		if (address + size > begin + pBlock->size)
+		{
+			const size_t blockSize{ std::max(size + alignment, GetCapacity()) };
+
+			m_UsedBytes += pBlock->size - m_Offset;
+			m_Blocks.push_back({ std::unique_ptr<std::byte[]>{ new std::byte[blockSize] }, blockSize });
+			m_Offset = 0;
+
+			pBlock = &m_Blocks.back();
+			begin = reinterpret_cast<uintptr_t>(pBlock->pMemory.get());
+			address = (begin + alignment - 1) & ~(alignment - 1);
+		}
+
+		const size_t end{ address + size - begin };
+
+		m_UsedBytes += end - m_Offset;
+		m_Offset = end;
+		m_HighWaterMark = std::max(m_HighWaterMark, m_UsedBytes);
+
+		return reinterpret_cast<void*>(address);
+	}
+
+	void FrameArena::Reset()
+	{
+		//One block that holds the biggest frame so far
+		if (m_Blocks.size() > 1)
+		{
+			const size_t capacity{ GetCapacity() };
+
+			m_Blocks.clear();
+			m_Blocks.push_back({ std::unique_ptr<std::byte[]>{ new std::byte[capacity] }, capacity });
+		}
+
+		m_Offset = 0;
+		m_UsedBytes = 0;
+	}
+
+	size_t FrameArena::GetUsedBytes() const
+	{
+		return m_UsedBytes;
+	}
+
+	size_t FrameArena::GetCapacity() const
+	{
+		size_t capacity{};
+		for (const Block& block : m_Blocks)
+		{
+			capacity += block.size;
+		}
+
+		return capacity;
+	}
+
+	size_t FrameArena::GetHighWaterMark() const
+	{
+		return m_HighWaterMark;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include <span>
+#include <type_traits>
+
+namespace dae
+{
+	//-----------------------------------------------------
+	// FrameArena Class
+	//-----------------------------------------------------
+
+	//Linear allocator for memory that only lives during one frame: allocating moves an offset, Reset at the start of the next frame frees everything at once.
+	//A frame that needs more gets an extra block, Reset merges the blocks into one. Once the high-water mark is reached a frame doesn't touch the heap.
+	//Not thread safe, every thread that needs scratch memory needs its own arena.
+	class FrameArena final
+	{
+	public:
+		explicit FrameArena(size_t capacity);
+		~FrameArena() = default;
+
+		FrameArena(const FrameArena& other) = delete;
+		FrameArena(FrameArena&& other) noexcept = delete;
+		FrameArena& operator=(const FrameArena& other) = delete;
+		FrameArena& operator=(FrameArena&& other) noexcept = delete;
+
+		//Storage for count elements, not initialized. Nothing is destroyed on Reset, so only for types without a destructor
+		template<typename T>
+		std::span<T> Allocate(size_t count)
+		{
+			static_assert(std::is_trivially_destructible_v<T>, "FrameArena memory is released without destroying the elements");
+
+			return { static_cast<T*>(Allocate(count * sizeof(T), alignof(T))), count };
+		}
+
+		//Alignment is a power of two
+		void* Allocate(size_t size, size_t alignment);
+
+		//Everything allocated since the last Reset is invalid afterwards
+		void Reset();
+
+		size_t GetUsedBytes() const;
+		size_t GetCapacity() const;
+		//Most bytes any frame used, padding included
+		size_t GetHighWaterMark() const;
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<std::byte[]> pMemory{};
+			size_t size{};
+		};
+
+		//Allocations come from the last block
+		std::vector<Block> m_Blocks{};
+		size_t m_Offset{};
+
+		size_t m_UsedBytes{};
+		size_t m_HighWaterMark{};
+	};
+}
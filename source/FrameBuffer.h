@@ -0,0 +1,113 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include <bit>
+#include <new>
+
+namespace dae
+{
+	//Where the pixels of a FrameBuffer are in memory.
+	//Tiled stores blocks of tileSize x tileSize pixels after each other, tiles row by row. Linear is the same with one tile per row that is wider than any buffer,
+	//so both use one formula and the raster loop doesn't branch on the layout.
+	struct FrameBufferLayout
+	{
+		int width{};
+		int height{};
+		int tileWidthShift{};
+		int tileHeightShift{};
+		int tileRowPitch{}; //Elements from one row of tiles to the next, the padded row when linear
+		int planeSize{}; //Elements per sample, a multiple of the alignment
+
+		int GetIndex(int px, int py) const
+		{
+			const int tileWidthMask{ (1 << tileWidthShift) - 1 };
+			const int tileHeightMask{ (1 << tileHeightShift) - 1 };
+
+			return (py >> tileHeightShift) * tileRowPitch
+				+ ((px >> tileWidthShift) << (tileWidthShift + tileHeightShift))
+				+ ((py & tileHeightMask) << tileWidthShift)
+				+ (px & tileWidthMask);
+		}
+	};
+
+	//-----------------------------------------------------
+	// FrameBuffer Class
+	//-----------------------------------------------------
+
+	//Color or depth samples of the software rasterizer, one plane per sample (sample major).
+	//Memory, rows and planes are aligned to a cache line: four pixels that start at a multiple of four can be loaded aligned,
+	//and a tile never shares a cache line with another tile.
+	template<typename T>
+	class FrameBuffer final
+	{
+	public:
+		static constexpr size_t alignment{ 64 };
+		static constexpr int tileSize{ 8 };
+
+		FrameBuffer() = default;
+		~FrameBuffer() = default;
+
+		FrameBuffer(const FrameBuffer& other) = delete;
+		FrameBuffer(FrameBuffer&& other) noexcept = delete;
+		FrameBuffer& operator=(const FrameBuffer& other) = delete;
+		FrameBuffer& operator=(FrameBuffer&& other) noexcept = delete;
+
+		//Keeps the memory when it is big enough, the contents are undefined afterwards
+		void Resize(int width, int height, int nrSamples, bool isTiled)
+		{
+			static_assert(alignment % sizeof(T) == 0 && (tileSize * tileSize * sizeof(T)) % alignment == 0, "Rows and tiles have to be a multiple of the alignment");
+			constexpr int alignmentElements{ static_cast<int>(alignment / sizeof(T)) };
+
+			if (isTiled)
+			{
+				constexpr int tileShift{ std::countr_zero(static_cast<unsigned int>(tileSize)) };
+				const int nrTilesX{ (width + tileSize - 1) / tileSize };
+				const int nrTilesY{ (height + tileSize - 1) / tileSize };
+
+				m_Layout = { width, height, tileShift, tileShift, nrTilesX * tileSize * tileSize, nrTilesX * nrTilesY * tileSize * tileSize };
+			}
+			else
+			{
+				const int stride{ (width + alignmentElements - 1) / alignmentElements * alignmentElements };
+
+				m_Layout = { width, height, 30, 0, stride, stride * height };
+			}
+
+			m_NrSamples = nrSamples;
+
+			const size_t nrElements{ static_cast<size_t>(m_Layout.planeSize) * nrSamples };
+			if (nrElements > m_Capacity)
+			{
+				m_pPixels.reset(static_cast<T*>(::operator new[](nrElements * sizeof(T), std::align_val_t{ alignment })));
+				m_Capacity = nrElements;
+			}
+		}
+
+		void Clear(T value)
+		{
+			std::fill_n(m_pPixels.get(), static_cast<size_t>(m_Layout.planeSize) * m_NrSamples, value);
+		}
+
+		T* GetPixels() { return m_pPixels.get(); }
+		const T* GetPixels() const { return m_pPixels.get(); }
+		const FrameBufferLayout& GetLayout() const { return m_Layout; }
+		int GetNrSamples() const { return m_NrSamples; }
+		size_t GetMemoryUsage() const { return m_Capacity * sizeof(T); }
+
+	private:
+		struct AlignedDelete
+		{
+			void operator()(T* pPixels) const
+			{
+				::operator delete[](pPixels, std::align_val_t{ alignment });
+			}
+		};
+
+		std::unique_ptr<T[], AlignedDelete> m_pPixels{};
+		size_t m_Capacity{};
+
+		FrameBufferLayout m_Layout{};
+		int m_NrSamples{};
+	};
+}
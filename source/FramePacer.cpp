@@ -0,0 +1,145 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "FramePacer.h"
+#include <thread>
+
+namespace dae
+{
+	//---------------------------
+	// Constructor & Destructor
+	//---------------------------
+
+	FramePacer::FramePacer(float targetFPS)
+		:m_TargetFPS{ targetFPS }
+		,m_MillisecondsPerCount{ 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency()) }
+		,m_CountsPerFrame{ static_cast<uint64_t>(static_cast<double>(SDL_GetPerformanceFrequency()) / targetFPS) }
+	{
+	}
+
+	//---------------------------
+	// Member functions
+	//---------------------------
+
+	void FramePacer::EndFrame(bool isIdle, bool isPresentSynced)
+	{
+		if (isIdle)
+		{
+			//Input wakes the loop at once, the next rendered frame starts a new schedule
+			SDL_WaitEventTimeout(nullptr, m_IdleTimeoutMilliseconds);
+
+			m_NextFrameCounter = 0;
+			m_PreviousFrameCounter = 0;
+			return;
+		}
+
+		const bool isPaced{ m_Mode == Mode::TargetFPS || (m_Mode == Mode::VSync && !isPresentSynced) };
+		const uint64_t currentCounter{ SDL_GetPerformanceCounter() };
+		const uint64_t dueCounter{ m_NextFrameCounter + m_CountsPerFrame };
+
+		//A late frame restarts the schedule, the frames after it don't try to catch up
+		if (isPaced && m_NextFrameCounter != 0 && dueCounter > currentCounter)
+		{
+			WaitUntil(dueCounter);
+			m_NextFrameCounter = dueCounter;
+		}
+		else
+		{
+			m_NextFrameCounter = currentCounter;
+		}
+
+		//Statistics
+		const uint64_t frameCounter{ SDL_GetPerformanceCounter() };
+
+		if (m_PreviousFrameCounter != 0)
+		{
+			const double interval{ static_cast<double>(frameCounter - m_PreviousFrameCounter) * m_MillisecondsPerCount };
+
+			++m_NrIntervals;
+			m_IntervalSum += interval;
+			m_IntervalSquaredSum += interval * interval;
+			m_MaxInterval = std::max(m_MaxInterval, interval);
+		}
+
+		m_PreviousFrameCounter = frameCounter;
+	}
+
+	void FramePacer::SetMode(Mode mode)
+	{
+		m_Mode = mode;
+		ResetStatistics();
+	}
+
+	FramePacer::Mode FramePacer::GetMode() const
+	{
+		return m_Mode;
+	}
+
+	float FramePacer::GetTargetFPS() const
+	{
+		return m_TargetFPS;
+	}
+
+	float FramePacer::GetAverageIntervalMilliseconds() const
+	{
+		return m_NrIntervals > 0 ? static_cast<float>(m_IntervalSum / m_NrIntervals) : 0.f;
+	}
+
+	float FramePacer::GetJitterMilliseconds() const
+	{
+		if (m_NrIntervals == 0) return 0.f;
+
+		const double average{ m_IntervalSum / m_NrIntervals };
+		const double variance{ m_IntervalSquaredSum / m_NrIntervals - average * average };
+
+		return static_cast<float>(std::sqrt(std::max(variance, 0.0)));
+	}
+
+	float FramePacer::GetMaxIntervalMilliseconds() const
+	{
+		return static_cast<float>(m_MaxInterval);
+	}
+
+	void FramePacer::ResetStatistics()
+	{
+		m_NrIntervals = 0;
+		m_IntervalSum = 0.0;
+		m_IntervalSquaredSum = 0.0;
+		m_MaxInterval = 0.0;
+	}
+
+	void FramePacer::WaitUntil(uint64_t counter)
+	{
+		uint64_t currentCounter{ SDL_GetPerformanceCounter() };
+
+		//Sleep in whole milliseconds while the frame is further away than the margin
+		while (currentCounter < counter)
+		{
+			const double remaining{ static_cast<double>(counter - currentCounter) * m_MillisecondsPerCount };
+			if (remaining <= m_SleepMarginMilliseconds) break;
+
+			//Positive here, a negative double can't be converted to an unsigned type
+			const Uint32 sleepMilliseconds{ static_cast<Uint32>(remaining - m_SleepMarginMilliseconds) };
+			if (sleepMilliseconds == 0) break;
+
+			SDL_Delay(sleepMilliseconds);
+
+			const uint64_t wakeCounter{ SDL_GetPerformanceCounter() };
+			const double overslept{ static_cast<double>(wakeCounter - currentCounter) * m_MillisecondsPerCount - sleepMilliseconds };
+
+			//Grows at once when the OS oversleeps more than the margin allows, shrinks slowly otherwise
+			const double margin{ overslept + m_MinSleepMarginMilliseconds };
+			m_SleepMarginMilliseconds = margin > m_SleepMarginMilliseconds ? margin : m_SleepMarginMilliseconds + 0.05 * (margin - m_SleepMarginMilliseconds);
+			m_SleepMarginMilliseconds = std::clamp(m_SleepMarginMilliseconds, m_MinSleepMarginMilliseconds, m_MaxSleepMarginMilliseconds);
+
+			currentCounter = wakeCounter;
+		}
+
+		//Spin for the rest, giving the core away in between
+		while (SDL_GetPerformanceCounter() < counter)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include <cstdint>
+
+namespace dae
+{
+	//-----------------------------------------------------
+	// FramePacer Class
+	//-----------------------------------------------------
+
+	//Ends every frame of the main loop: waits until the next frame is due, or for input when nothing was rendered.
+	//Waiting sleeps for most of the time and spins for the last part, the sleep margin adapts to how much the OS oversleeps.
+	class FramePacer final
+	{
+	public:
+		enum class Mode
+		{
+			Uncapped,
+			TargetFPS,
+			VSync //Present waits for the vertical blank, paced like TargetFPS when the present can't
+		};
+
+		explicit FramePacer(float targetFPS);
+		~FramePacer() = default;
+
+		// -------------------------
+		// Copy/move constructors and assignment operators
+		// -------------------------
+		FramePacer(const FramePacer& other) = delete;
+		FramePacer(FramePacer&& other) noexcept = delete;
+		FramePacer& operator=(const FramePacer& other) = delete;
+		FramePacer& operator=(FramePacer&& other)	noexcept = delete;
+
+		//-------------------------------------------------
+		// Member functions
+		//-------------------------------------------------
+
+		//isIdle: nothing was rendered, blocks until there is input (or the idle timeout passed, assets may still be loading)
+		//isPresentSynced: the present of this frame already waited for the vertical blank
+		void EndFrame(bool isIdle, bool isPresentSynced);
+
+		void SetMode(Mode mode);
+		Mode GetMode() const;
+		float GetTargetFPS() const;
+
+		//Intervals between rendered frames since the last reset, idle frames are left out
+		float GetAverageIntervalMilliseconds() const;
+		float GetJitterMilliseconds() const; //Standard deviation
+		float GetMaxIntervalMilliseconds() const;
+		void ResetStatistics();
+
+	private:
+		//-------------------------------------------------
+		// Private member functions
+		//-------------------------------------------------
+		void WaitUntil(uint64_t counter);
+
+		//-------------------------------------------------
+		// Datamembers
+		//-------------------------------------------------
+		Mode m_Mode{ Mode::TargetFPS };
+		const float m_TargetFPS;
+
+		const double m_MillisecondsPerCount;
+		const uint64_t m_CountsPerFrame;
+
+		//Counter value the next frame is due at, 0 after an idle frame
+		uint64_t m_NextFrameCounter{};
+		uint64_t m_PreviousFrameCounter{};
+
+		//Sleeping stops this long before the frame is due, the rest is spent spinning
+		double m_SleepMarginMilliseconds{ 2.0 };
+		static constexpr double m_MinSleepMarginMilliseconds{ 0.5 };
+		static constexpr double m_MaxSleepMarginMilliseconds{ 16.0 };
+
+		static constexpr int m_IdleTimeoutMilliseconds{ 50 };
+
+		//Statistics
+		uint32_t m_NrIntervals{};
+		double m_IntervalSum{};
+		double m_IntervalSquaredSum{};
+		double m_MaxInterval{};
+	};
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "Math.h"
+
+namespace dae
+{
+	struct BoundingBox
+	{
+		Vector3 min{};
+		Vector3 max{};
+
+		Vector3 GetCenter() const
+		{
+			return (min + max) * 0.5f;
+		}
+
+		//Axis aligned box around the transformed box (Arvo)
+		BoundingBox Transform(const Matrix& matrix) const
+		{
+			const Vector3 translation{ matrix.GetTranslation() };
+			BoundingBox result{ translation, translation };
+
+			for (int row{}; row < 3; ++row)
+			{
+				for (int column{}; column < 3; ++column)
+				{
+					const float a{ matrix[row][column] * min[row] };
+					const float b{ matrix[row][column] * max[row] };
+
+					result.min[column] += std::min(a, b);
+					result.max[column] += std::max(a, b);
+				}
+			}
+
+			return result;
+		}
+	};
+
+	struct BoundingSphere
+	{
+		Vector3 center{};
+		float radius{};
+
+		BoundingSphere Transform(const Matrix& matrix) const
+		{
+			const float scale{ std::sqrt(std::max(matrix.GetAxisX().SqrMagnitude(), std::max(matrix.GetAxisY().SqrMagnitude(), matrix.GetAxisZ().SqrMagnitude()))) };
+
+			return { matrix.TransformPoint(center), radius * scale };
+		}
+	};
+
+	//Planes point inwards: dot(plane.xyz, p) + plane.w >= 0 for points inside
+	struct Frustum
+	{
+		enum Plane { Left, Right, Bottom, Top, Near, Far, NrPlanes };
+
+		Vector4 planes[NrPlanes]{};
+
+		//Gribb/Hartmann plane extraction for row vectors (p * viewProjection) and a [0, 1] depth range
+		static Frustum Create(const Matrix& viewProjection)
+		{
+			const auto getColumn = [&viewProjection](int column) -> Vector4
+			{
+				return { viewProjection[0][column], viewProjection[1][column], viewProjection[2][column], viewProjection[3][column] };
+			};
+
+			const Vector4 x{ getColumn(0) };
+			const Vector4 y{ getColumn(1) };
+			const Vector4 z{ getColumn(2) };
+			const Vector4 w{ getColumn(3) };
+
+			Frustum frustum{};
+			frustum.planes[Left] = w + x;
+			frustum.planes[Right] = w - x;
+			frustum.planes[Bottom] = w + y;
+			frustum.planes[Top] = w - y;
+			frustum.planes[Near] = z;
+			frustum.planes[Far] = w - z;
+
+			for (Vector4& plane : frustum.planes)
+			{
+				plane = plane * (1.f / plane.GetXYZ().Magnitude());
+			}
+
+			return frustum;
+		}
+
+		bool IsVisible(const BoundingSphere& sphere) const
+		{
+			for (const Vector4& plane : planes)
+			{
+				if (Vector3::Dot(plane.GetXYZ(), sphere.center) + plane.w < -sphere.radius) return false;
+			}
+
+			return true;
+		}
+
+		bool IsVisible(const BoundingBox& box) const
+		{
+			for (const Vector4& plane : planes)
+			{
+				//Corner furthest along the plane normal
+				const Vector3 positiveCorner
+				{
+					plane.x >= 0.f ? box.max.x : box.min.x,
+					plane.y >= 0.f ? box.max.y : box.min.y,
+					plane.z >= 0.f ? box.max.z : box.min.z
+				};
+
+				if (Vector3::Dot(plane.GetXYZ(), positiveCorner) + plane.w < 0.f) return false;
+			}
+
+			return true;
+		}
+	};
+}
@@ -0,0 +1,142 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "Heatmap.h"
+#include <numeric>
+
+namespace
+{
+	//Blue, cyan, green, yellow, red for t in [0, 1]
+	uint32_t GetHeatColor(float t, const SDL_PixelFormat* pFormat)
+	{
+		constexpr uint8_t colors[5][3]{ { 0, 0, 255 }, { 0, 255, 255 }, { 0, 255, 0 }, { 255, 255, 0 }, { 255, 0, 0 } };
+
+		const float position{ std::clamp(t, 0.f, 1.f) * 4.f };
+		const int index{ std::min(static_cast<int>(position), 3) };
+		const float weight{ position - index };
+
+		const auto lerp = [weight](uint8_t a, uint8_t b) { return static_cast<uint8_t>(a + (b - a) * weight); };
+
+		return SDL_MapRGB(pFormat,
+			lerp(colors[index][0], colors[index + 1][0]),
+			lerp(colors[index][1], colors[index + 1][1]),
+			lerp(colors[index][2], colors[index + 1][2]));
+	}
+
+	template<typename CountType>
+	uint64_t GetPercentile(const std::vector<CountType>& counts, std::vector<uint64_t>& sortedCounts, float percentile)
+	{
+		//Pixels without counts would pull the percentile to zero
+		sortedCounts.clear();
+		for (CountType count : counts)
+		{
+			if (count != 0) sortedCounts.push_back(count);
+		}
+
+		if (sortedCounts.empty()) return 0;
+
+		//Nearest rank
+		const size_t rank{ static_cast<size_t>(percentile * (sortedCounts.size() - 1) + 0.5f) };
+		std::nth_element(sortedCounts.begin(), sortedCounts.begin() + rank, sortedCounts.end());
+
+		return sortedCounts[rank];
+	}
+}
+
+namespace dae
+{
+	//---------------------------
+	// Member functions
+	//---------------------------
+
+	void Heatmap::Begin(int width, int height)
+	{
+		const size_t nrPixels{ static_cast<size_t>(width) * height };
+
+		m_Width = width;
+		m_Height = height;
+		m_NrTilesX = (width + tileSize - 1) / tileSize;
+
+		m_Fragments.assign(nrPixels, 0);
+		m_DepthFails.assign(nrPixels, 0);
+		m_ShadingCycles.assign(nrPixels, 0);
+		m_TileCycles.assign(static_cast<size_t>(m_NrTilesX) * ((height + tileSize - 1) / tileSize), 0);
+	}
+
+	void Heatmap::Draw(HeatmapMode mode, uint32_t* pPixels, int stride, const SDL_PixelFormat* pFormat)
+	{
+		if (mode == HeatmapMode::Off) return;
+
+		m_Scale = std::max(CalculateScale(mode), uint64_t{ 1 });
+
+		const float scale{ static_cast<float>(m_Scale) };
+		const uint32_t black{ SDL_MapRGB(pFormat, 0, 0, 0) };
+
+		const auto getCount = [this, mode](int px, int py) -> uint64_t
+		{
+			const int pixelIndex{ px + py * m_Width };
+
+			switch (mode)
+			{
+			case HeatmapMode::Overdraw:
+				return m_Fragments[pixelIndex];
+			case HeatmapMode::DepthFails:
+				return m_DepthFails[pixelIndex];
+			case HeatmapMode::ShadingCost:
+				return m_ShadingCycles[pixelIndex];
+			default:
+			case HeatmapMode::TileTime:
+				return m_TileCycles[(py / tileSize) * m_NrTilesX + px / tileSize];
+			}
+		};
+
+		for (int py{}; py < m_Height; ++py)
+		{
+			for (int px{}; px < m_Width; ++px)
+			{
+				const uint64_t count{ getCount(px, py) };
+				pPixels[px + py * stride] = count == 0 ? black : GetHeatColor(count / scale, pFormat);
+			}
+		}
+	}
+
+	uint64_t Heatmap::GetScale() const
+	{
+		return m_Scale;
+	}
+
+	uint64_t Heatmap::GetTotal(HeatmapMode mode) const
+	{
+		switch (mode)
+		{
+		case HeatmapMode::Overdraw:
+			return std::accumulate(m_Fragments.begin(), m_Fragments.end(), uint64_t{});
+		case HeatmapMode::DepthFails:
+			return std::accumulate(m_DepthFails.begin(), m_DepthFails.end(), uint64_t{});
+		case HeatmapMode::ShadingCost:
+			return std::accumulate(m_ShadingCycles.begin(), m_ShadingCycles.end(), uint64_t{});
+		case HeatmapMode::TileTime:
+			return std::accumulate(m_TileCycles.begin(), m_TileCycles.end(), uint64_t{});
+		default:
+			return 0;
+		}
+	}
+
+	uint64_t Heatmap::CalculateScale(HeatmapMode mode)
+	{
+		switch (mode)
+		{
+		case HeatmapMode::Overdraw:
+			return m_MaxFragments;
+		case HeatmapMode::DepthFails:
+			return m_MaxDepthFails;
+		case HeatmapMode::ShadingCost:
+			return GetPercentile(m_ShadingCycles, m_SortedCycles, 0.99f);
+		case HeatmapMode::TileTime:
+			return GetPercentile(m_TileCycles, m_SortedCycles, 0.99f);
+		default:
+			return 0;
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include "DataTypes.h"
+#include <intrin.h>
+
+namespace dae
+{
+	//-----------------------------------------------------
+	// Heatmap Class
+	//-----------------------------------------------------
+
+	//Per pixel counters of the software rasterizer, to see which parts of the meshes are expensive.
+	//The meshes only count while a heatmap is shown. Cycles are read with rdtsc, so they include the counting itself and a thread switch shows up as a hot spot.
+	class Heatmap final
+	{
+	public:
+		Heatmap() = default;
+		~Heatmap() = default;
+
+		Heatmap(const Heatmap& other) = delete;
+		Heatmap(Heatmap&& other) noexcept = delete;
+		Heatmap& operator=(const Heatmap& other) = delete;
+		Heatmap& operator=(Heatmap&& other) noexcept = delete;
+
+		static constexpr int tileSize{ 16 };
+
+		//Clears the counters, resizes when the resolution changed
+		void Begin(int width, int height);
+
+		//Fragments that passed the depth test, blended fragments included
+		void AddFragment(int pixelIndex)
+		{
+			++m_Fragments[pixelIndex];
+		}
+
+		//Covered samples that failed the depth test
+		void AddDepthFails(int pixelIndex, uint32_t nrSamples)
+		{
+			m_DepthFails[pixelIndex] += nrSamples;
+		}
+
+		//Interpolation and shading of one fragment
+		void AddShadingCycles(int pixelIndex, uint64_t cycles)
+		{
+			m_ShadingCycles[pixelIndex] += static_cast<uint32_t>(cycles);
+		}
+
+		//Everything the raster loop did in the tile of the pixel
+		void AddTileCycles(int px, int py, uint64_t cycles)
+		{
+			m_TileCycles[(py / tileSize) * m_NrTilesX + px / tileSize] += cycles;
+		}
+
+		static uint64_t GetCycles()
+		{
+			return __rdtsc();
+		}
+
+		//Replaces the colors (stride pixels per row) with the counters of the mode, from blue (few) to red (the scale or more), black where nothing was counted
+		void Draw(HeatmapMode mode, uint32_t* pPixels, int stride, const SDL_PixelFormat* pFormat);
+
+		//Count that the last Draw showed as red
+		uint64_t GetScale() const;
+		uint64_t GetTotal(HeatmapMode mode) const;
+
+	private:
+		//Fixed for fragments and depth fails, the 99th percentile of the frame for cycles (so a single slow pixel doesn't wash out the rest)
+		uint64_t CalculateScale(HeatmapMode mode);
+
+		int m_Width{};
+		int m_Height{};
+		int m_NrTilesX{};
+
+		std::vector<uint32_t> m_Fragments{};
+		std::vector<uint32_t> m_DepthFails{};
+		std::vector<uint32_t> m_ShadingCycles{};
+		std::vector<uint64_t> m_TileCycles{};
+
+		//Nonzero cycle counts, sorted for the percentile
+		std::vector<uint64_t> m_SortedCycles{};
+		uint64_t m_Scale{};
+
+		static constexpr uint64_t m_MaxFragments{ 8 };
+		static constexpr uint64_t m_MaxDepthFails{ 8 };
+	};
+}
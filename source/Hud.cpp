@@ -0,0 +1,157 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "Hud.h"
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+	//ASCII 32 to 95, lower case is drawn as upper case. Five rows of three pixels, the highest bit is the left pixel
+	constexpr uint8_t font[64][5]
+	{
+		{ 0,0,0,0,0 }, { 2,2,2,0,2 }, { 5,5,0,0,0 }, { 5,7,5,7,5 }, { 3,6,7,3,6 }, { 5,1,2,4,5 }, { 2,5,2,5,3 }, { 2,2,0,0,0 }, // !"#$%&'
+		{ 1,2,2,2,1 }, { 4,2,2,2,4 }, { 0,5,2,5,0 }, { 0,2,7,2,0 }, { 0,0,0,2,4 }, { 0,0,7,0,0 }, { 0,0,0,0,2 }, { 1,1,2,4,4 }, //()*+,-./
+		{ 7,5,5,5,7 }, { 2,6,2,2,7 }, { 7,1,7,4,7 }, { 7,1,3,1,7 }, { 5,5,7,1,1 }, { 7,4,7,1,7 }, { 7,4,7,5,7 }, { 7,1,1,2,2 }, //01234567
+		{ 7,5,7,5,7 }, { 7,5,7,1,7 }, { 0,2,0,2,0 }, { 0,2,0,2,4 }, { 1,2,4,2,1 }, { 0,7,0,7,0 }, { 4,2,1,2,4 }, { 7,1,3,0,2 }, //89:;<=>?
+		{ 2,5,7,4,3 }, { 2,5,7,5,5 }, { 6,5,6,5,6 }, { 3,4,4,4,3 }, { 6,5,5,5,6 }, { 7,4,6,4,7 }, { 7,4,6,4,4 }, { 3,4,5,5,3 }, //@ABCDEFG
+		{ 5,5,7,5,5 }, { 7,2,2,2,7 }, { 1,1,1,5,2 }, { 5,5,6,5,5 }, { 4,4,4,4,7 }, { 5,7,7,5,5 }, { 6,5,5,5,5 }, { 2,5,5,5,2 }, //HIJKLMNO
+		{ 6,5,6,4,4 }, { 2,5,5,6,3 }, { 6,5,6,5,5 }, { 3,4,2,1,6 }, { 7,2,2,2,2 }, { 5,5,5,5,7 }, { 5,5,5,5,2 }, { 5,5,7,7,5 }, //PQRSTUVW
+		{ 5,5,2,5,5 }, { 5,5,2,2,2 }, { 7,1,2,4,7 }, { 3,2,2,2,3 }, { 4,4,2,1,1 }, { 6,2,2,2,6 }, { 2,5,0,0,0 }, { 0,0,0,0,7 }  //XYZ[\]^_
+	};
+}
+
+namespace dae
+{
+	//---------------------------
+	// Member functions
+	//---------------------------
+
+	void Hud::Update(const Timer* pTimer)
+	{
+		m_FrameTimes[m_NrFrames++ % m_NrGraphFrames] = pTimer->GetElapsed() * 1000.f;
+
+		std::snprintf(m_FrameLine.data(), maxLineLength, "FRAME %.2f MS, MEDIAN %.2f, 99%% %.2f, HUD %.3f",
+			pTimer->GetElapsed() * 1000.f, pTimer->GetFrameTimePercentile(0.5f), pTimer->GetFrameTimePercentile(0.99f), m_DrawMilliseconds);
+
+		//Share of the frame per stage of the main thread, the stage that waits is the idle time
+		double frameMilliseconds{};
+		for (uint32_t lap{}; lap < pTimer->GetNrLaps(); ++lap)
+		{
+			frameMilliseconds += pTimer->GetLap(lap).milliseconds;
+		}
+
+		int length{ std::snprintf(m_LapLine.data(), maxLineLength, "LAP SHARE:") };
+		for (uint32_t lap{}; lap < pTimer->GetNrLaps() && length < maxLineLength; ++lap)
+		{
+			const Timer::LapTime& lapTime{ pTimer->GetLap(lap) };
+			const int percentage{ frameMilliseconds > 0.0 ? static_cast<int>(100.0 * lapTime.milliseconds / frameMilliseconds + 0.5) : 0 };
+
+			length += std::snprintf(m_LapLine.data() + length, maxLineLength - length, " %s %d%%", lapTime.pName, percentage);
+		}
+	}
+
+	void Hud::Draw(SDL_Surface* pSurface, float budgetMilliseconds)
+	{
+		const auto start{ std::chrono::steady_clock::now() };
+
+		if (pSurface->format->BytesPerPixel == 4)
+		{
+			uint32_t* pPixels{ static_cast<uint32_t*>(pSurface->pixels) };
+			const int pitch{ pSurface->pitch / 4 };
+
+			//Panel, sized to the longest line and clipped to the surface
+			int nrColumns{ static_cast<int>(std::max(std::strlen(m_FrameLine.data()), std::strlen(m_LapLine.data()))) };
+			for (int line{}; line < m_NrLines; ++line)
+			{
+				nrColumns = std::max(nrColumns, static_cast<int>(std::strlen(m_Lines[line].data())));
+			}
+
+			const int panelWidth{ std::min(std::max(nrColumns * m_CharacterWidth, m_NrGraphFrames) + 2 * m_Margin, pSurface->w) };
+			const int panelHeight{ std::min(m_GraphHeight + (m_NrLines + 2) * m_LineHeight + 3 * m_Margin, pSurface->h) };
+
+			//Darkened, the scene stays visible. Works for every 8 bit per channel layout
+			for (int y{}; y < panelHeight; ++y)
+			{
+				uint32_t* pRow{ pPixels + y * pitch };
+				for (int x{}; x < panelWidth; ++x)
+				{
+					pRow[x] = (pRow[x] >> 2) & 0x3F3F3F3F;
+				}
+			}
+
+			const uint32_t white{ SDL_MapRGB(pSurface->format, 255, 255, 255) };
+			const uint32_t green{ SDL_MapRGB(pSurface->format, 64, 224, 64) };
+			const uint32_t red{ SDL_MapRGB(pSurface->format, 240, 64, 64) };
+			const uint32_t gray{ SDL_MapRGB(pSurface->format, 128, 128, 128) };
+
+			//Frame time graph, oldest frame on the left. The line is the budget
+			const float pixelsPerMillisecond{ 0.5f * m_GraphHeight / budgetMilliseconds };
+			const int graphBottom{ m_Margin + m_GraphHeight };
+			const int nrGraphFrames{ std::min(static_cast<int>(m_NrFrames), std::min(m_NrGraphFrames, panelWidth - 2 * m_Margin)) };
+
+			for (int frame{}; frame < nrGraphFrames; ++frame)
+			{
+				const float milliseconds{ m_FrameTimes[(m_NrFrames - nrGraphFrames + frame) % m_NrGraphFrames] };
+				const int barHeight{ std::min(static_cast<int>(milliseconds * pixelsPerMillisecond + 0.5f), m_GraphHeight) };
+
+				FillRectangle(pPixels, pitch, m_Margin + frame, graphBottom - barHeight, 1, barHeight, milliseconds > budgetMilliseconds ? red : green);
+			}
+
+			FillRectangle(pPixels, pitch, m_Margin, graphBottom - m_GraphHeight / 2, panelWidth - 2 * m_Margin, 1, gray);
+
+			//Text, lines below the panel are left out
+			int y{ graphBottom + m_Margin };
+
+			DrawText(pPixels, pitch, m_Margin, y, panelWidth, m_FrameLine.data(), white);
+			y += m_LineHeight;
+			DrawText(pPixels, pitch, m_Margin, y, panelWidth, m_LapLine.data(), white);
+			y += m_LineHeight;
+
+			for (int line{}; line < m_NrLines && y + m_LineHeight <= panelHeight; ++line, y += m_LineHeight)
+			{
+				DrawText(pPixels, pitch, m_Margin, y, panelWidth, m_Lines[line].data(), white);
+			}
+		}
+
+		m_NrLines = 0;
+		m_DrawMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	float Hud::GetDrawMilliseconds() const
+	{
+		return m_DrawMilliseconds;
+	}
+
+	void Hud::DrawText(uint32_t* pPixels, int pitch, int x, int y, int maxX, const char* pText, uint32_t color) const
+	{
+		for (; *pText != '\0' && x + m_CharacterWidth <= maxX; ++pText, x += m_CharacterWidth)
+		{
+			int character{ static_cast<unsigned char>(*pText) };
+			if (character >= 'a' && character <= 'z') character -= 'a' - 'A';
+			if (character < 32 || character > 95) character = '?';
+
+			const uint8_t* pGlyph{ font[character - 32] };
+
+			for (int row{}; row < 5; ++row)
+			{
+				for (int column{}; column < 3; ++column)
+				{
+					if (pGlyph[row] >> (2 - column) & 0x01)
+					{
+						FillRectangle(pPixels, pitch, x + column * m_Scale, y + row * m_Scale, m_Scale, m_Scale, color);
+					}
+				}
+			}
+		}
+	}
+
+	void Hud::FillRectangle(uint32_t* pPixels, int pitch, int x, int y, int width, int height, uint32_t color)
+	{
+		for (int row{ y }; row < y + height; ++row)
+		{
+			std::fill_n(pPixels + row * pitch + x, width, color);
+		}
+	}
+}
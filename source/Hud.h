@@ -0,0 +1,87 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include <array>
+#include <cstdio>
+
+namespace dae
+{
+	class Timer;
+
+	//-----------------------------------------------------
+	// Hud Class
+	//-----------------------------------------------------
+
+	//Statistics panel drawn over the final image with a 3x5 bitmap font: a frame time graph, the stages of the main thread and lines of text.
+	//Lines are added every frame and cleared by Draw, nothing is allocated after construction.
+	class Hud final
+	{
+	public:
+		Hud() = default;
+		~Hud() = default;
+
+		// -------------------------
+		// Copy/move constructors and assignment operators
+		// -------------------------
+		Hud(const Hud& other) = delete;
+		Hud(Hud&& other) noexcept = delete;
+		Hud& operator=(const Hud& other) = delete;
+		Hud& operator=(Hud&& other)	noexcept = delete;
+
+		//-------------------------------------------------
+		// Member functions
+		//-------------------------------------------------
+
+		//Frame times and the laps of the last frame
+		void Update(const Timer* pTimer);
+
+		//printf style, lines that don't fit are dropped
+		template<typename... Arguments>
+		void AddLine(const char* pFormat, Arguments... arguments)
+		{
+			if (m_NrLines >= maxNrLines) return;
+
+			std::snprintf(m_Lines[m_NrLines++].data(), maxLineLength, pFormat, arguments...);
+		}
+
+		//Draws into a locked 32 bit surface, the graph is scaled so the budget is halfway
+		void Draw(SDL_Surface* pSurface, float budgetMilliseconds);
+
+		//Time the last Draw took
+		float GetDrawMilliseconds() const;
+
+		static constexpr int maxNrLines{ 16 };
+		static constexpr int maxLineLength{ 64 };
+
+	private:
+		//-------------------------------------------------
+		// Private member functions
+		//-------------------------------------------------
+		void DrawText(uint32_t* pPixels, int pitch, int x, int y, int maxX, const char* pText, uint32_t color) const;
+		static void FillRectangle(uint32_t* pPixels, int pitch, int x, int y, int width, int height, uint32_t color);
+
+		//-------------------------------------------------
+		// Datamembers
+		//-------------------------------------------------
+		std::array<std::array<char, maxLineLength>, maxNrLines> m_Lines{};
+		int m_NrLines{};
+
+		//Rolling, written at m_NrFrames % nrGraphFrames
+		static constexpr int m_NrGraphFrames{ 128 };
+		std::array<float, m_NrGraphFrames> m_FrameTimes{};
+		uint32_t m_NrFrames{};
+
+		std::array<char, maxLineLength> m_FrameLine{};
+		std::array<char, maxLineLength> m_LapLine{};
+
+		float m_DrawMilliseconds{};
+
+		//Glyphs are scaled up, 3x5 pixels is too small to read
+		static constexpr int m_Scale{ 2 };
+		static constexpr int m_CharacterWidth{ 4 * m_Scale };
+		static constexpr int m_LineHeight{ 7 * m_Scale };
+		static constexpr int m_Margin{ 4 };
+		static constexpr int m_GraphHeight{ 48 };
+	};
+}
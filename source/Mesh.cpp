@@ -5,48 +5,106 @@
 #include "Mesh.h"
 #include "Texture.h"
 #include <iostream>
+#include <limits>
 #include "Utils.h"
 #include "Effect.h"
 #include "Camera.h"
+#include "FrameArena.h"
 
 //---------------------------
 // Constructor & Destructor
 //---------------------------
 
-Mesh::Mesh(ID3D11Device* pDevice, const std::string& filename)
+Mesh::Mesh(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat)
+	:m_VertexFormat{ vertexFormat }
+	,m_Vertices{ meshData.vertices }
+	,m_NrVertices{ static_cast<uint32_t>(meshData.vertices.size()) }
+	,m_Indices{ meshData.indices }
+	,m_LODs{ meshData.lods }
+	,m_PrimitiveTopology{ meshData.topology }
 {
-	dae::Utils::ParseOBJ(filename, m_Vertices, m_Indices);
-	m_VerticesOut.resize(m_Vertices.size());
+	CalculateBoundingVolumes();
 
 	m_IsTriangleList = { m_PrimitiveTopology == PrimitiveTopology::TriangleList };
 
 	m_Increment = m_IsTriangleList * 3 + !m_IsTriangleList * 1;
-	m_MaxCount = static_cast<int>(m_Indices.size()) + !m_IsTriangleList * (-2);
+
+	//Meshes without levels of detail draw everything
+	if (m_LODs.empty())
+	{
+		m_LODs.push_back({ 0, static_cast<uint32_t>(m_Indices.size()), static_cast<uint32_t>(m_Vertices.size()) });
+	}
+
+	m_LODInstanceWorldMatrices.resize(m_LODs.size());
+	m_LODStatistics.nrInstances.resize(m_LODs.size());
+
+	//Compress, the full vertices are not kept
+	if (m_VertexFormat == VertexFormat::Compressed)
+	{
+		m_PositionQuantization = dae::PositionQuantization::Create(m_BoundingBox);
+		m_CompressedVertices.reserve(m_Vertices.size());
+
+		for (const Vertex& vertex : m_Vertices)
+		{
+			dae::CompressedVertex& compressedVertex{ m_CompressedVertices.emplace_back() };
+
+			for (int axis{}; axis < 3; ++axis)
+			{
+				compressedVertex.position[axis] = dae::VertexCompression::EncodeUnorm((vertex.position[axis] - m_PositionQuantization.offset[axis]) / (m_PositionQuantization.scale[axis] * 65535.f));
+			}
+
+			compressedVertex.position[3] = vertex.handedness < 0.f ? 0 : UINT16_MAX;
+			compressedVertex.uv[0] = dae::VertexCompression::FloatToHalf(vertex.uv.x);
+			compressedVertex.uv[1] = dae::VertexCompression::FloatToHalf(vertex.uv.y);
+
+			dae::VertexCompression::EncodeOctahedral(vertex.normal, compressedVertex.normal);
+			dae::VertexCompression::EncodeOctahedral(vertex.tangent, compressedVertex.tangent);
+		}
+
+		m_Vertices.clear();
+		m_Vertices.shrink_to_fit();
+	}
+
+	const bool isCompressed{ m_VertexFormat == VertexFormat::Compressed };
+	const uint32_t nrVertices{ m_NrVertices };
 
 	//Create Vertex Buffer
 	D3D11_BUFFER_DESC bd{};
 	bd.Usage = D3D11_USAGE_IMMUTABLE;
-	bd.ByteWidth = sizeof(Vertex) * static_cast<uint32_t>(m_Vertices.size());
+	bd.ByteWidth = (isCompressed ? sizeof(dae::CompressedVertex) : sizeof(Vertex)) * nrVertices;
 	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	bd.CPUAccessFlags = 0;
 	bd.MiscFlags = 0;
 
 	D3D11_SUBRESOURCE_DATA initData{};
-	initData.pSysMem = m_Vertices.data();
+	initData.pSysMem = isCompressed ? static_cast<const void*>(m_CompressedVertices.data()) : static_cast<const void*>(m_Vertices.data());
 
 	HRESULT result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
 	if (FAILED(result)) return;
 
-	//Create Index Buffer
+	//Create Index Buffer, half the size when the vertices fit in 16 bit indices
 	m_NumIndices = static_cast<uint32_t>(m_Indices.size());
 
+	const bool useShortIndices{ nrVertices <= UINT16_MAX };
+
+	if (useShortIndices)
+	{
+		m_IndexFormat = DXGI_FORMAT_R16_UINT;
+		//Restart indices are all ones in both formats
+		m_ShortIndices.resize(m_Indices.size());
+		std::transform(m_Indices.begin(), m_Indices.end(), m_ShortIndices.begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+
+		m_Indices.clear();
+		m_Indices.shrink_to_fit();
+	}
+
 	bd.Usage = D3D11_USAGE_IMMUTABLE;
-	bd.ByteWidth = sizeof(uint32_t) * m_NumIndices;
+	bd.ByteWidth = (useShortIndices ? sizeof(uint16_t) : sizeof(uint32_t)) * m_NumIndices;
 	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	bd.CPUAccessFlags = 0;
 	bd.MiscFlags = 0;
 
-	initData.pSysMem = m_Indices.data();
+	initData.pSysMem = useShortIndices ? static_cast<const void*>(m_ShortIndices.data()) : static_cast<const void*>(m_Indices.data());
 
 	result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
 	if (FAILED(result)) return;
@@ -54,6 +112,11 @@ Mesh::Mesh(ID3D11Device* pDevice, const std::string& filename)
 
 Mesh::~Mesh()
 {
+	if (m_pInstanceBuffer)
+	{
+		m_pInstanceBuffer->Release();
+	}
+
 	if (m_pIndexBuffer)
 	{
 		m_pIndexBuffer->Release();
@@ -71,19 +134,26 @@ Mesh::~Mesh()
 
 void Mesh::Render(ID3D11DeviceContext* pDeviceContext)
 {
+	const UINT nrInstances{ static_cast<UINT>(m_InstanceWorldMatrices.size()) };
+	if (nrInstances == 0) return;
+
+	//0. Upload the instance world matrices
+	if (!UpdateInstanceBuffer(pDeviceContext)) return;
+
 	//1. Set Primitive Topology
-	pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	pDeviceContext->IASetPrimitiveTopology(m_IsTriangleList ? D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
 
 	//2. Set Input Layout
 	pDeviceContext->IASetInputLayout(m_pEffect->GetInputLayout());
 
-	//3. Set VertexBuffer
-	constexpr UINT stride{ sizeof(Vertex) };
-	constexpr UINT offset{ 0 };
-	pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
+	//3. Set VertexBuffer (slot 0) & InstanceBuffer (slot 1)
+	ID3D11Buffer* pBuffers[2]{ m_pVertexBuffer, m_pInstanceBuffer };
+	const UINT strides[2]{ m_VertexFormat == VertexFormat::Compressed ? sizeof(dae::CompressedVertex) : sizeof(Vertex), sizeof(dae::Matrix) };
+	constexpr UINT offsets[2]{ 0, 0 };
+	pDeviceContext->IASetVertexBuffers(0, 2, pBuffers, strides, offsets);
 
 	//4. Set IndexBuffer
-	pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, m_IndexFormat, 0);
 
 	//5. Draw
 	D3DX11_TECHNIQUE_DESC techDesc{};
@@ -92,7 +162,18 @@ void Mesh::Render(ID3D11DeviceContext* pDeviceContext)
 	for (UINT p{}; p < techDesc.Passes; ++p)
 	{
 		m_pEffect->GetTechnique()->GetPassByIndex(p)->Apply(0, pDeviceContext);
-		pDeviceContext->DrawIndexed(m_NumIndices, 0, 0);
+
+		//One draw per level of detail, its instances are next to each other in the instance buffer
+		UINT firstInstance{};
+
+		for (size_t lod{}; lod < m_LODs.size(); ++lod)
+		{
+			const UINT nrLODInstances{ m_LODStatistics.nrInstances[lod] };
+			if (nrLODInstances == 0) continue;
+
+			pDeviceContext->DrawIndexedInstanced(m_LODs[lod].nrIndices, nrLODInstances, m_LODs[lod].firstIndex, 0, firstInstance);
+			firstInstance += nrLODInstances;
+		}
 	}
 }
 
@@ -108,7 +189,7 @@ void Mesh::SetRasterizerState(ID3D11RasterizerState* pRasterizerState)
 
 void Mesh::SetMatrices(dae::Camera* pCamera)
 {
-	m_pEffect->SetMatrices(pCamera, m_WorldMatrix);
+	m_pEffect->SetMatrices(pCamera);
 }
 
 void Mesh::Translate(const dae::Vector3& translation)
@@ -116,9 +197,9 @@ void Mesh::Translate(const dae::Vector3& translation)
 	m_WorldMatrix = dae::Matrix::CreateTranslation(m_WorldMatrix.GetTranslation() + translation);
 }
 
-void Mesh::RotateY(float angle)
+void Mesh::SetRotationY(float angle)
 {
-	m_WorldMatrix = dae::Matrix::CreateRotationY(angle) * m_WorldMatrix;
+	m_WorldMatrix = dae::Matrix::CreateRotationY(angle) * dae::Matrix::CreateTranslation(m_WorldMatrix.GetTranslation());
 }
 
 void Mesh::SetBoundingBoxVisibitily(bool showBoundingBox)
@@ -131,4 +212,352 @@ void Mesh::SetDepthVisibility(bool showDepth)
 	m_ShowDepth = showDepth;
 }
 
+void Mesh::SetHeatmap(dae::Heatmap* pHeatmap)
+{
+	m_pHeatmap = pHeatmap;
+}
+
+const CullStatistics& Mesh::GetCullStatistics() const
+{
+	return m_CullStatistics;
+}
+
+size_t Mesh::GetMemoryUsage() const
+{
+	return m_Vertices.capacity() * sizeof(Vertex)
+		+ m_CompressedVertices.capacity() * sizeof(dae::CompressedVertex)
+		+ m_Indices.capacity() * sizeof(uint32_t)
+		+ m_ShortIndices.capacity() * sizeof(uint16_t)
+		+ m_InstanceWorldMatrices.capacity() * sizeof(dae::Matrix);
+}
+
+size_t Mesh::UpdateInstances(const std::vector<dae::Matrix>& instances, const dae::Frustum& frustum, const dae::Camera& camera)
+{
+	for (std::vector<dae::Matrix>& lodInstances : m_LODInstanceWorldMatrices)
+	{
+		lodInstances.clear();
+	}
+
+	for (const dae::Matrix& instance : instances)
+	{
+		const dae::Matrix worldMatrix{ m_WorldMatrix * instance };
+
+		if (IsVisible(frustum, worldMatrix))
+		{
+			m_LODInstanceWorldMatrices[SelectLOD(worldMatrix, camera)].push_back(worldMatrix);
+		}
+	}
+
+	//Sort by level, so both rasterizers can handle one level at a time
+	m_InstanceWorldMatrices.clear();
+	m_LODStatistics.nrFullDetailTriangles = 0;
+	m_LODStatistics.nrSelectedTriangles = 0;
+
+	for (size_t lod{}; lod < m_LODs.size(); ++lod)
+	{
+		const std::vector<dae::Matrix>& lodInstances{ m_LODInstanceWorldMatrices[lod] };
+		const uint32_t nrLODInstances{ static_cast<uint32_t>(lodInstances.size()) };
+
+		m_InstanceWorldMatrices.insert(m_InstanceWorldMatrices.end(), lodInstances.begin(), lodInstances.end());
+
+		m_LODStatistics.nrInstances[lod] = nrLODInstances;
+		m_LODStatistics.nrFullDetailTriangles += nrLODInstances * (m_LODs[0].nrIndices / 3);
+		m_LODStatistics.nrSelectedTriangles += nrLODInstances * (m_LODs[lod].nrIndices / 3);
+	}
+
+	return m_InstanceWorldMatrices.size();
+}
+
+size_t Mesh::GetNrVisibleInstances() const
+{
+	return m_InstanceWorldMatrices.size();
+}
+
+const LODStatistics& Mesh::GetLODStatistics() const
+{
+	return m_LODStatistics;
+}
+
+int Mesh::SelectLOD(const dae::Matrix& worldMatrix, const dae::Camera& camera) const
+{
+	const dae::BoundingSphere sphere{ m_BoundingSphere.Transform(worldMatrix) };
+
+	//Fraction of the screen height covered by the bounding sphere, camera.fov is tan(fovAngle / 2)
+	const float distance{ (sphere.center - camera.origin).Magnitude() };
+	const float screenSize{ distance > sphere.radius ? sphere.radius / (distance * camera.fov) : 1.f };
+
+	int lod{};
+	float lodScreenSize{ m_LODScreenSize };
+
+	while (lod + 1 < static_cast<int>(m_LODs.size()) && screenSize < lodScreenSize)
+	{
+		++lod;
+		lodScreenSize *= 0.5f;
+	}
+
+	return lod;
+}
+
+size_t Mesh::GetNrTriangles(const MeshLOD& lod) const
+{
+	//A strip of n indices has n - 2 triangles, restarts included
+	const int maxCount{ static_cast<int>(lod.nrIndices) + !m_IsTriangleList * (-2) };
+	return maxCount > 0 ? (static_cast<size_t>(maxCount) - 1) / m_Increment + 1 : 0;
+}
+
+bool Mesh::IsVisible(const dae::Frustum& frustum, const dae::Matrix& worldMatrix) const
+{
+	//The sphere test is cheaper but looser, the box only has to be tested when the sphere intersects the frustum
+	return frustum.IsVisible(m_BoundingSphere.Transform(worldMatrix)) && frustum.IsVisible(m_BoundingBox.Transform(worldMatrix));
+}
+
+const dae::BoundingBox& Mesh::GetBoundingBox() const
+{
+	return m_BoundingBox;
+}
+
+const dae::BoundingSphere& Mesh::GetBoundingSphere() const
+{
+	return m_BoundingSphere;
+}
+
+VertexFormat Mesh::GetVertexFormat() const
+{
+	return m_VertexFormat;
+}
+
+void Mesh::AllocateFrameBuffers(dae::FrameArena& frameArena)
+{
+	size_t maxNrTriangles{};
+	size_t maxNrBatchVertices{};
+
+	for (size_t lod{}; lod < m_LODs.size(); ++lod)
+	{
+		const uint32_t nrBatchInstances{ std::min(m_LODStatistics.nrInstances[lod], GetBatchSize(m_LODs[lod])) };
+
+		maxNrTriangles = std::max(maxNrTriangles, GetNrTriangles(m_LODs[lod]));
+		maxNrBatchVertices = std::max(maxNrBatchVertices, static_cast<size_t>(nrBatchInstances) * m_LODs[lod].nrVertices);
+	}
+
+	//Written before they are read: the vertices of a batch by the vertex transformation, the triangles by CullTriangles
+	m_BatchVerticesOut = frameArena.Allocate<VertexOut>(maxNrBatchVertices);
+	m_VerticesOut = {};
+	m_TriangleBuffer = frameArena.Allocate<TriangleIndices>(maxNrTriangles);
+	m_VisibleTriangles = {};
+}
+
+uint32_t Mesh::GetBatchSize(const MeshLOD& lod) const
+{
+	//At least one instance, even when a level has more vertices than a batch
+	return std::max(m_MaxBatchVertices / std::max(lod.nrVertices, uint32_t{ 1 }), uint32_t{ 1 });
+}
+
+void Mesh::TransformToRasterSpace(int width, int height, std::span<VertexOut> vertices)
+{
+	for (VertexOut& vertex : vertices)
+	{
+		//NDC space -> Raster space
+		vertex.position.x = 0.5f * (vertex.position.x + 1.f) * width;
+		vertex.position.y = 0.5f * (1.f - vertex.position.y) * height;
+	}
+}
+
+void Mesh::CullTriangles(int width, int height, const MeshLOD& lod)
+{
+	if (m_IndexFormat == DXGI_FORMAT_R16_UINT)
+	{
+		CullTriangles(width, height, lod, m_ShortIndices);
+	}
+	else
+	{
+		CullTriangles(width, height, lod, m_Indices);
+	}
+}
+
+template<typename IndexType>
+void Mesh::CullTriangles(int width, int height, const MeshLOD& lod, const std::vector<IndexType>& indices)
+{
+	//Triangles are tested in batches, every test in a batch is branchless so the lane loops can be vectorized
+	constexpr int batchSize{ 8 };
+	constexpr IndexType restartIndex{ std::numeric_limits<IndexType>::max() };
+
+	const size_t nrTriangles{ GetNrTriangles(lod) };
+	const float cullSign{ m_CullMode == CullMode::BackFaceCulling ? 1.f : -1.f };
+	const bool useCullMode{ m_CullMode != CullMode::NoCulling };
+
+	size_t nrVisibleTriangles{};
+
+	//Statistics are summed over all instances, they are reset in SoftwareRender
+	m_CullStatistics.nrSubmitted += static_cast<uint32_t>(nrTriangles);
+	uint32_t nrRestarts{};
+
+	for (size_t firstTriangle{}; firstTriangle < nrTriangles; firstTriangle += batchSize)
+	{
+		const int nrLanes{ static_cast<int>(std::min<size_t>(batchSize, nrTriangles - firstTriangle)) };
+
+		uint32_t corners[3][batchSize]{};
+		bool isRestart[batchSize]{};
+		float x[3][batchSize]{};
+		float y[3][batchSize]{};
+		float z[3][batchSize]{};
+
+		//Gather
+		for (int lane{}; lane < nrLanes; ++lane)
+		{
+			const size_t relativeIndex{ (firstTriangle + lane) * m_Increment };
+			const size_t index{ lod.firstIndex + relativeIndex };
+
+			//Odd triangles of a strip have the opposite winding
+			const bool shouldSwap{ !m_IsTriangleList && relativeIndex & 0x01 };
+
+			corners[0][lane] = indices[index];
+			corners[1][lane] = indices[index + (shouldSwap ? 2 : 1)];
+			corners[2][lane] = indices[index + (shouldSwap ? 1 : 2)];
+
+			//Windows over a cut between strips are no triangles, they gather vertex 0 and are skipped
+			for (int corner{}; corner < 3; ++corner)
+			{
+				const bool isCut{ corners[corner][lane] == restartIndex };
+				isRestart[lane] |= isCut;
+				corners[corner][lane] *= !isCut;
+			}
+
+			for (int corner{}; corner < 3; ++corner)
+			{
+				const dae::Vector4& position{ m_VerticesOut[corners[corner][lane]].position };
 
+				x[corner][lane] = position.x;
+				y[corner][lane] = position.y;
+				z[corner][lane] = position.z;
+			}
+		}
+
+		bool isFrustumCulled[batchSize]{};
+		bool isDegenerate[batchSize]{};
+		bool isBackFaceCulled[batchSize]{};
+
+		for (int lane{}; lane < batchSize; ++lane)
+		{
+			//Frustrum culling: a vertex outside the depth range, or all vertices on the outside of one screen border
+			const bool isOutsideDepth{ (z[0][lane] < 0.f) | (z[0][lane] > 1.f) | (z[1][lane] < 0.f) | (z[1][lane] > 1.f) | (z[2][lane] < 0.f) | (z[2][lane] > 1.f) };
+			const bool isLeft{ (x[0][lane] < 0.f) & (x[1][lane] < 0.f) & (x[2][lane] < 0.f) };
+			const bool isRight{ (x[0][lane] > width) & (x[1][lane] > width) & (x[2][lane] > width) };
+			const bool isAbove{ (y[0][lane] < 0.f) & (y[1][lane] < 0.f) & (y[2][lane] < 0.f) };
+			const bool isBelow{ (y[0][lane] > height) & (y[1][lane] > height) & (y[2][lane] > height) };
+
+			isFrustumCulled[lane] = isOutsideDepth | isLeft | isRight | isAbove | isBelow;
+
+			//Discard triangles where two indices are the same or without area
+			const float area{ (x[1][lane] - x[0][lane]) * (y[2][lane] - y[0][lane]) - (y[1][lane] - y[0][lane]) * (x[2][lane] - x[0][lane]) };
+
+			isDegenerate[lane] = (corners[0][lane] == corners[1][lane]) | (corners[0][lane] == corners[2][lane]) | (corners[1][lane] == corners[2][lane]) | (area == 0.f);
+
+			//Cullmode
+			isBackFaceCulled[lane] = useCullMode & (cullSign * area < 0.f);
+		}
+
+		//Compact the survivors
+		for (int lane{}; lane < nrLanes; ++lane)
+		{
+			if (isRestart[lane])
+			{
+				++nrRestarts;
+			}
+			else if (isFrustumCulled[lane])
+			{
+				++m_CullStatistics.nrFrustumCulled;
+			}
+			else if (isDegenerate[lane])
+			{
+				++m_CullStatistics.nrDegenerate;
+			}
+			else if (isBackFaceCulled[lane])
+			{
+				++m_CullStatistics.nrBackFaceCulled;
+			}
+			else
+			{
+				m_TriangleBuffer[nrVisibleTriangles++] = { corners[0][lane], corners[1][lane], corners[2][lane] };
+			}
+		}
+	}
+
+	m_VisibleTriangles = m_TriangleBuffer.first(nrVisibleTriangles);
+
+	m_CullStatistics.nrSubmitted -= nrRestarts;
+	m_CullStatistics.nrVisible += static_cast<uint32_t>(nrVisibleTriangles);
+}
+
+bool Mesh::UpdateInstanceBuffer(ID3D11DeviceContext* pDeviceContext)
+{
+	const size_t nrInstances{ m_InstanceWorldMatrices.size() };
+
+	//Recreate the buffer when it is too small, with room to grow
+	if (nrInstances > m_InstanceCapacity)
+	{
+		if (m_pInstanceBuffer)
+		{
+			m_pInstanceBuffer->Release();
+			m_pInstanceBuffer = nullptr;
+		}
+
+		m_InstanceCapacity = std::max(nrInstances, m_InstanceCapacity * 2);
+
+		D3D11_BUFFER_DESC bd{};
+		bd.Usage = D3D11_USAGE_DYNAMIC;
+		bd.ByteWidth = sizeof(dae::Matrix) * static_cast<uint32_t>(m_InstanceCapacity);
+		bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bd.MiscFlags = 0;
+
+		ID3D11Device* pDevice{};
+		pDeviceContext->GetDevice(&pDevice);
+
+		const HRESULT result{ pDevice->CreateBuffer(&bd, nullptr, &m_pInstanceBuffer) };
+		pDevice->Release();
+
+		if (FAILED(result))
+		{
+			m_InstanceCapacity = 0;
+			return false;
+		}
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource{};
+	const HRESULT result{ pDeviceContext->Map(m_pInstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource) };
+	if (FAILED(result)) return false;
+
+	std::memcpy(mappedResource.pData, m_InstanceWorldMatrices.data(), sizeof(dae::Matrix) * nrInstances);
+	pDeviceContext->Unmap(m_pInstanceBuffer, 0);
+
+	return true;
+}
+
+void Mesh::CalculateBoundingVolumes()
+{
+	if (m_Vertices.empty()) return;
+
+	m_BoundingBox = { m_Vertices[0].position, m_Vertices[0].position };
+
+	for (const Vertex& vertex : m_Vertices)
+	{
+		m_BoundingBox.min.x = std::min(m_BoundingBox.min.x, vertex.position.x);
+		m_BoundingBox.min.y = std::min(m_BoundingBox.min.y, vertex.position.y);
+		m_BoundingBox.min.z = std::min(m_BoundingBox.min.z, vertex.position.z);
+
+		m_BoundingBox.max.x = std::max(m_BoundingBox.max.x, vertex.position.x);
+		m_BoundingBox.max.y = std::max(m_BoundingBox.max.y, vertex.position.y);
+		m_BoundingBox.max.z = std::max(m_BoundingBox.max.z, vertex.position.z);
+	}
+
+	//Sphere around the center of the box, tight enough for culling
+	m_BoundingSphere.center = m_BoundingBox.GetCenter();
+
+	float sqrRadius{};
+	for (const Vertex& vertex : m_Vertices)
+	{
+		sqrRadius = std::max(sqrRadius, (vertex.position - m_BoundingSphere.center).SqrMagnitude());
+	}
+
+	m_BoundingSphere.radius = std::sqrt(sqrRadius);
+}
@@ -3,11 +3,17 @@
 // Include Files
 //-----------------------------------------------------
 #include "DataTypes.h"
+#include "Frustum.h"
+#include "VertexCompression.h"
+#include <span>
 class Effect;
 class Texture;
 namespace dae
 {
 	struct Camera;
+	class Heatmap;
+	class FrameArena;
+	struct FrameBufferLayout;
 }
 
 struct Vertex
@@ -16,6 +22,7 @@ struct Vertex
 	dae::Vector2 uv{};
 	dae::Vector3 normal{};
 	dae::Vector3 tangent{};
+	float handedness{ 1.f }; //Bitangent = handedness * cross(normal, tangent), -1 where the uvs are mirrored
 };
 
 struct VertexOut
@@ -24,16 +31,63 @@ struct VertexOut
 	dae::Vector2 uv{};
 	dae::Vector3 normal{};
 	dae::Vector3 tangent{};
+	float handedness{};
 	dae::Vector3 viewDirection{};
 };
 
+//Level of detail, a range of the index buffer that only uses the first nrVertices vertices
+struct MeshLOD
+{
+	uint32_t firstIndex{};
+	uint32_t nrIndices{};
+	uint32_t nrVertices{};
+};
+
+//Geometry as it is loaded from disk, shared by every mesh that is created from the same file
+struct MeshData
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+
+	//Full detail first, empty when the indices are one level
+	std::vector<MeshLOD> lods{};
+
+	//Strips of every level start at an even index, relative to the level
+	PrimitiveTopology topology{ PrimitiveTopology::TriangleList };
+};
+
+//Triangle that survived culling, winding is already corrected for triangle strips
+struct TriangleIndices
+{
+	uint32_t i0{};
+	uint32_t i1{};
+	uint32_t i2{};
+};
+
+struct CullStatistics
+{
+	uint32_t nrSubmitted{};
+	uint32_t nrFrustumCulled{};
+	uint32_t nrBackFaceCulled{};
+	uint32_t nrDegenerate{};
+	uint32_t nrVisible{};
+};
+
+//Triangles of the selected levels of detail compared to drawing every visible instance at full detail
+struct LODStatistics
+{
+	uint32_t nrFullDetailTriangles{};
+	uint32_t nrSelectedTriangles{};
+	std::vector<uint32_t> nrInstances{}; //Per level
+};
+
 //-----------------------------------------------------
 // Mesh Class									
 //-----------------------------------------------------
 class Mesh
 {
 public:
-	Mesh(ID3D11Device* pDevice, const std::string& filePath );
+	Mesh(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat);
 	virtual ~Mesh();
 
 	// -------------------------
@@ -48,32 +102,79 @@ public:
 	// Member functions						
 	//-------------------------------------------------
 	void Render(ID3D11DeviceContext* pDeviceContext);
-	virtual void SoftwareRender(int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels) = 0;
+	//nrSamples is 1 or 4 (multisampling), the buffers then hold one plane per sample. Color and depth have the same layout (see dae::FrameBuffer)
+	//Transient buffers come from the frame arena, they are only valid until it is reset
+	virtual void SoftwareRender(const dae::FrameBufferLayout& layout, int nrSamples, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels, dae::FrameArena& frameArena) = 0;
 
 	void SetSamplerState(ID3D11SamplerState* pSamplerState);
 	void SetRasterizerState(ID3D11RasterizerState* pRasterizerState);
 	void SetMatrices(dae::Camera* pCamera);
 
 	void Translate(const dae::Vector3& translation);
-	void RotateY(float angle);
+	//Replaces the rotation, keeps the translation
+	void SetRotationY(float angle);
 
 	virtual void PrintTypeName() = 0;
 
 	void SetBoundingBoxVisibitily(bool showBoundingBox);
 	void SetDepthVisibility(bool showDepth);
+	//Counts into the heatmap while rasterizing, nullptr when no heatmap is shown
+	void SetHeatmap(dae::Heatmap* pHeatmap);
+
+	const CullStatistics& GetCullStatistics() const;
+
+	//Bytes of the software geometry and buffers, the DirectX buffers hold another copy of the vertices and indices
+	virtual size_t GetMemoryUsage() const;
+
+	//Combines the mesh transform with every instance transform and keeps the instances inside the frustum, returns how many are visible
+	//Every visible instance selects a level of detail from its size on screen
+	size_t UpdateInstances(const std::vector<dae::Matrix>& instances, const dae::Frustum& frustum, const dae::Camera& camera);
+	size_t GetNrVisibleInstances() const;
+	const LODStatistics& GetLODStatistics() const;
+
+	bool IsVisible(const dae::Frustum& frustum, const dae::Matrix& worldMatrix) const;
+	const dae::BoundingBox& GetBoundingBox() const;
+	const dae::BoundingSphere& GetBoundingSphere() const;
+	VertexFormat GetVertexFormat() const;
 protected:
 	//-------------------------------------------------
 	// Private member functions								
 	//-------------------------------------------------
+	//Allocates the vertex and triangle buffers of this frame, big enough for a batch of every level of detail
+	void AllocateFrameBuffers(dae::FrameArena& frameArena);
+	//Instances per batch: the vertices of a batch are transformed together, then its instances are culled and rasterized one after the other
+	uint32_t GetBatchSize(const MeshLOD& lod) const;
+	void TransformToRasterSpace(int width, int height, std::span<VertexOut> vertices);
+	void CullTriangles(int width, int height, const MeshLOD& lod);
+	template<typename IndexType>
+	void CullTriangles(int width, int height, const MeshLOD& lod, const std::vector<IndexType>& indices);
+	int SelectLOD(const dae::Matrix& worldMatrix, const dae::Camera& camera) const;
+	size_t GetNrTriangles(const MeshLOD& lod) const;
+	void CalculateBoundingVolumes();
+	bool UpdateInstanceBuffer(ID3D11DeviceContext* pDeviceContext);
 	
 	//-------------------------------------------------
 	// Datamembers								
 	//-------------------------------------------------
 
-	//Software
+	//Software, only one of the vertex arrays is filled, depending on the vertex format
+	VertexFormat m_VertexFormat;
 	std::vector<Vertex> m_Vertices{};
-	std::vector<VertexOut> m_VerticesOut{};
+	std::vector<dae::CompressedVertex> m_CompressedVertices{};
+	dae::PositionQuantization m_PositionQuantization{};
+	uint32_t m_NrVertices{};
+	//Frame arena memory, see AllocateFrameBuffers. The vertices of a batch of instances, m_VerticesOut are those of the instance that is rasterized
+	std::span<VertexOut> m_BatchVerticesOut{};
+	std::span<VertexOut> m_VerticesOut{};
+	static constexpr uint32_t m_MaxBatchVertices{ 1 << 15 };
+	//Only one of the index arrays is filled, 16 bit indices when every vertex can be addressed with them
 	std::vector<uint32_t> m_Indices{};
+	std::vector<uint16_t> m_ShortIndices{};
+	DXGI_FORMAT m_IndexFormat{ DXGI_FORMAT_R32_UINT };
+	//The visible triangles of one instance, the first part of the triangle buffer
+	std::span<TriangleIndices> m_TriangleBuffer{};
+	std::span<TriangleIndices> m_VisibleTriangles{};
+	CullStatistics m_CullStatistics{};
 
 	//Direct X
 	std::unique_ptr<Effect> m_pEffect;
@@ -83,17 +184,37 @@ protected:
 	ID3D11Buffer* m_pVertexBuffer;
 	ID3D11Buffer* m_pIndexBuffer;
 
+	//Per instance world matrices, grows when more instances are visible
+	ID3D11Buffer* m_pInstanceBuffer{};
+	size_t m_InstanceCapacity{};
+
 	//Other
 	dae::Matrix m_WorldMatrix{};
+
+	//World matrices of the visible instances, shared by both rasterizers
+	//Sorted by level of detail, m_LODStatistics.nrInstances has the number of instances per level
+	std::vector<dae::Matrix> m_InstanceWorldMatrices{};
+	std::vector<std::vector<dae::Matrix>> m_LODInstanceWorldMatrices{};
+
+	//Levels of detail, full detail first
+	std::vector<MeshLOD> m_LODs{};
+	LODStatistics m_LODStatistics{};
+
+	//Instances whose bounding sphere covers less than this fraction of the screen height use the next level, halved for every level after
+	static constexpr float m_LODScreenSize{ 0.5f };
+
+	//Object space
+	dae::BoundingBox m_BoundingBox{};
+	dae::BoundingSphere m_BoundingSphere{};
+
 	bool m_ShowBoundingbox{ false };
 	bool m_ShowDepth{ false };
+	dae::Heatmap* m_pHeatmap{ nullptr };
 
 	CullMode m_CullMode{CullMode::BackFaceCulling};
 
-	enum class PrimitiveTopology{TriangleList, TriangleStrip};
 	PrimitiveTopology m_PrimitiveTopology{ PrimitiveTopology::TriangleList };
 
 	bool m_IsTriangleList{ true };
 	int m_Increment{ 1 };
-	int m_MaxCount{};
 };
\ No newline at end of file
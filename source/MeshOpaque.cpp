@@ -6,18 +6,26 @@
 #include "Texture.h"
 #include "EffectOpaque.h"
 #include "Utils.h"
+#include "TriangleSetup.h"
+#include "FastMath.h"
+#include "ShadingRate.h"
+#include "Heatmap.h"
+#include "FrameBuffer.h"
+#include "FrameArena.h"
+#include <bit>
 
 //---------------------------
 // Constructor & Destructor
 //---------------------------
 
-MeshOpaque::MeshOpaque(ID3D11Device* pDevice, const std::string& filename, Texture* pDiffuseMap, Texture* pNormalMap, Texture* pSpecularMap, Texture* pGlossinessMap)
-	:Mesh(pDevice, filename)
+MeshOpaque::MeshOpaque(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat, Texture* pDiffuseMap, Texture* pNormalMap, Texture* pSpecularMap, Texture* pGlossinessMap)
+	:Mesh(pDevice, meshData, vertexFormat)
 {
 	PrintTypeName();
 
 	//Effect
-	m_pEffect = std::make_unique<EffectOpaque>(pDevice, L"Resources/Opaque.fx");
+	m_pEffect = std::make_unique<EffectOpaque>(pDevice, L"Resources/Opaque.fx", m_VertexFormat);
+	m_pEffect->SetPositionQuantization(m_PositionQuantization);
 
 	SetDiffuseMap(pDiffuseMap);
 	SetNormalMap(pNormalMap);
@@ -29,81 +37,361 @@ MeshOpaque::MeshOpaque(ID3D11Device* pDevice, const std::string& filename, Textu
 // Member functions
 //---------------------------
 
-void MeshOpaque::SoftwareRender(int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels)
+void MeshOpaque::SoftwareRender(const dae::FrameBufferLayout& layout, int nrSamples, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels, dae::FrameArena& frameArena)
 {
+	const int width{ layout.width };
+	const int height{ layout.height };
 	EffectOpaque* pEffect{ static_cast<EffectOpaque*>(m_pEffect.get()) };
 	
-	pEffect->VertexTransformationFunction(m_Vertices, m_VerticesOut, m_Indices);
+	const RasterizeFunction rasterizeFunction{ nrSamples > 1 ? SelectRasterizeFunction<4>() : SelectRasterizeFunction<1>() };
+	m_CullStatistics = {};
+	m_ShadingStatistics = {};
 
-	for (size_t index{}; index < m_Vertices.size(); ++index)
+	AllocateFrameBuffers(frameArena);
+
+	//Empty blocks, no triangle has key 0
+	m_CoarseShadingBlocks = frameArena.Allocate<CoarseShadingBlock>(width);
+	std::fill(m_CoarseShadingBlocks.begin(), m_CoarseShadingBlocks.end(), CoarseShadingBlock{});
+
+	//The debug views don't shade, the history is dropped so it is not reused once shading again
+	const bool useTemporalCache{ m_UseTemporalCache && !m_ShowBoundingbox && !m_ShowDepth };
+
+	if (useTemporalCache)
+	{
+		BeginTemporalFrame(width, height, rasterizeFunction);
+		m_BatchPreviousPositions = frameArena.Allocate<dae::Vector3>(m_BatchVerticesOut.size());
+	}
+	else
+	{
+		m_HistoryRasterizeFunction = nullptr;
+	}
+
+	//Instances only move with the mesh, so the world matrix of an instance in the last frame is motionMatrix * worldMatrix
+	const dae::Matrix motionMatrix{ m_PreviousWorldMatrix * dae::Matrix::Inverse(m_WorldMatrix) };
+
+	//The instances share the vertex buffers. The vertices of a batch of instances are transformed together, then its instances are rasterized one after the other
+	//Instances are sorted by level of detail, a level only transforms the vertices it uses
+	const dae::Matrix* pWorldMatrix{ m_InstanceWorldMatrices.data() };
+
+	for (size_t lod{}; lod < m_LODs.size(); ++lod)
+	{
+		const MeshLOD& meshLOD{ m_LODs[lod] };
+		const uint32_t nrVertices{ meshLOD.nrVertices };
+		const uint32_t nrInstances{ m_LODStatistics.nrInstances[lod] };
+		const uint32_t batchSize{ GetBatchSize(meshLOD) };
+
+		for (uint32_t firstInstance{}; firstInstance < nrInstances; firstInstance += batchSize)
+		{
+			const uint32_t nrBatchInstances{ std::min(batchSize, nrInstances - firstInstance) };
+			const std::span<VertexOut> batchVertices{ m_BatchVerticesOut.first(static_cast<size_t>(nrBatchInstances) * nrVertices) };
+
+			for (uint32_t instance{}; instance < nrBatchInstances; ++instance)
+			{
+				const size_t firstVertex{ static_cast<size_t>(instance) * nrVertices };
+
+				pEffect->SetWorldMatrix(pWorldMatrix[instance]);
+				if (m_VertexFormat == VertexFormat::Compressed)
+				{
+					pEffect->VertexTransformationFunction(m_CompressedVertices, batchVertices.subspan(firstVertex, nrVertices), nrVertices);
+				}
+				else
+				{
+					pEffect->VertexTransformationFunction(m_Vertices, batchVertices.subspan(firstVertex, nrVertices), nrVertices);
+				}
+
+				if (useTemporalCache)
+				{
+					const dae::Matrix previousWorldViewProjection{ motionMatrix * pWorldMatrix[instance] * m_PreviousViewProjectionMatrix };
+					const std::span<dae::Vector3> previousPositions{ m_BatchPreviousPositions.subspan(firstVertex, nrVertices) };
+
+					if (m_VertexFormat == VertexFormat::Compressed)
+					{
+						TransformPreviousPositions(m_CompressedVertices, previousWorldViewProjection, previousPositions);
+					}
+					else
+					{
+						TransformPreviousPositions(m_Vertices, previousWorldViewProjection, previousPositions);
+					}
+				}
+			}
+
+			TransformToRasterSpace(width, height, batchVertices);
+
+			for (uint32_t instance{}; instance < nrBatchInstances; ++instance)
+			{
+				const size_t firstVertex{ static_cast<size_t>(instance) * nrVertices };
+
+				m_VerticesOut = batchVertices.subspan(firstVertex, nrVertices);
+				if (useTemporalCache) m_PreviousPositions = m_BatchPreviousPositions.subspan(firstVertex, nrVertices);
+
+				CullTriangles(width, height, meshLOD);
+
+				//Specialized raster loop, picked once per frame (rasterizeFunction) so the modes are not checked per pixel
+				(this->*rasterizeFunction)(layout, pBackBuffer, pBackBufferPixels, pDepthBufferPixels);
+			}
+
+			pWorldMatrix += nrBatchInstances;
+		}
+	}
+
+	//This frame is the history of the next one
+	if (useTemporalCache)
+	{
+		std::swap(m_History, m_Current);
+		m_PreviousWorldMatrix = m_WorldMatrix;
+		m_PreviousViewProjectionMatrix = pEffect->GetViewProjectionMatrix();
+	}
+}
+
+template<typename VertexType>
+void MeshOpaque::TransformPreviousPositions(const std::vector<VertexType>& vertices, const dae::Matrix& previousWorldViewProjection, std::span<dae::Vector3> previousPositions)
+{
+	for (size_t index{}; index < previousPositions.size(); ++index)
 	{
-		//NDC space -> Raster space
-		m_VerticesOut[index].position.x = 0.5f * (m_VerticesOut[index].position.x + 1.f) * width;
-		m_VerticesOut[index].position.y = 0.5f * (1.f - m_VerticesOut[index].position.y) * height;
+		dae::Vector3 position{};
+
+		if constexpr (std::is_same_v<VertexType, dae::CompressedVertex>)
+		{
+			position = dae::VertexCompression::DecodePosition(vertices[index], m_PositionQuantization);
+		}
+		else
+		{
+			position = vertices[index].position;
+		}
+
+		const dae::Vector4 clipPosition{ previousWorldViewProjection.TransformPoint(dae::Vector4{ position.x, position.y, position.z, 0.f }) };
+		previousPositions[index] = { clipPosition.x, clipPosition.y, clipPosition.w };
 	}
+}
 
-	for (size_t index{}; index < m_MaxCount; index += m_Increment)
+void MeshOpaque::BeginTemporalFrame(int width, int height, RasterizeFunction rasterizeFunction)
+{
+	const size_t nrPixels{ static_cast<size_t>(width) * height };
+
+	//Colors of another resolution or shading mode can't be reused, an empty history never matches (w is 0)
+	if (width != m_HistoryWidth || height != m_HistoryHeight || rasterizeFunction != m_HistoryRasterizeFunction)
 	{
-		//Frustrum culling
-		if (m_VerticesOut[m_Indices[index]].position.z < 0.f || m_VerticesOut[m_Indices[index]].position.z > 1.f ||
-			m_VerticesOut[m_Indices[index + 1]].position.z < 0.f || m_VerticesOut[m_Indices[index + 1]].position.z > 1.f ||
-			m_VerticesOut[m_Indices[index + 2]].position.z < 0.f || m_VerticesOut[m_Indices[index + 2]].position.z > 1.f) continue;
+		m_History.assign(nrPixels, TemporalPixel{});
+		m_HistoryWidth = width;
+		m_HistoryHeight = height;
+		m_HistoryRasterizeFunction = rasterizeFunction;
 
-		//Discard triangles where two indices are the same
-		if (m_Indices[index] == m_Indices[index + 1] || m_Indices[index] == m_Indices[index + 2] || m_Indices[index + 1] == m_Indices[index + 2]) continue;
+		m_PreviousWorldMatrix = m_WorldMatrix;
+		m_PreviousViewProjectionMatrix = m_pEffect->GetViewProjectionMatrix();
+	}
+
+	m_Current.assign(nrPixels, TemporalPixel{});
+	++m_TemporalFrame;
+}
 
-		//Vertices
-		const dae::Vector2 v0{ m_VerticesOut[m_Indices[index]].position.GetXY() };
-		const dae::Vector2 v1{ m_VerticesOut[m_Indices[index + 1]].position.GetXY() };
-		const dae::Vector2 v2{ m_VerticesOut[m_Indices[index + 2]].position.GetXY() };
+template<int nrSamples, bool showBoundingBox, bool showDepth, bool useNormalMap, RenderMode renderMode, ShadingQuality shadingQuality>
+void MeshOpaque::RasterizeTriangles(const dae::FrameBufferLayout& layout, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels)
+{
+	const EffectOpaque* pEffect{ static_cast<EffectOpaque*>(m_pEffect.get()) };
+	const int width{ layout.width };
+	const int height{ layout.height };
+	const int planeSize{ layout.planeSize };
+
+	//Adaptive shading needs the rates of the previous frame, it is full rate without them
+	const bool isAdaptive{ m_ShadingRate == ShadingRate::Adaptive && m_pShadingRateImage };
+	const bool useCoarseShading{ isAdaptive || (m_ShadingRate != ShadingRate::Rate1x1 && m_ShadingRate != ShadingRate::Adaptive) };
+	const dae::Int2 uniformBlockSize{ dae::GetShadingBlockSize(m_ShadingRate) };
+
+	//Temporal cache, a quarter of the pixels is reshaded every frame (one pixel of every 2x2 quad, in dither order), the rest reuses the last frame where it can
+	const bool useTemporalCache{ !showBoundingBox && !showDepth && m_UseTemporalCache };
+	static constexpr int refreshOrder[4]{ 0, 3, 1, 2 };
+	const int refreshQuadPixel{ refreshOrder[m_TemporalFrame % 4] };
+
+	//Reshaded pixels are shaded at a jittered position around the corner, the next position every time the pixel is refreshed.
+	//Averaged with the history, the cached colors converge to a supersampled shading
+	const int jitterIndex{ static_cast<int>(m_TemporalFrame / 4 % 4) };
+	const float jitterX{ useTemporalCache ? dae::SamplePattern<4>::x[jitterIndex] - 0.5f : 0.f };
+	const float jitterY{ useTemporalCache ? dae::SamplePattern<4>::y[jitterIndex] - 0.5f : 0.f };
+
+	//Per byte (history * n + color) / (n + 1), the channel order of the format doesn't matter
+	const auto accumulateColor = [](uint32_t historyColor, uint32_t color, uint32_t nrHistoryShadings)
+	{
+		uint32_t result{};
 
-		//Cullmode
-		const bool shouldSwap{ !m_IsTriangleList && index & 0x01 };
-		const float area{ (shouldSwap ? -1 : 1) * dae::Vector2::Cross(v1 - v0, v2 - v0) };
+		for (int shift{}; shift < 32; shift += 8)
+		{
+			const uint32_t historyChannel{ historyColor >> shift & 0xFF };
+			const uint32_t channel{ color >> shift & 0xFF };
 
-		if ((m_CullMode == CullMode::FrontFaceCulling && area > 0.f) || (m_CullMode == CullMode::BackFaceCulling && area < 0.f)) continue;
+			result |= ((historyChannel * nrHistoryShadings + channel) / (nrHistoryShadings + 1)) << shift;
+		}
 
-		//Get values for boundingbox
-		dae::Vector2 min{ std::min(v0.x, v1.x),std::min(v0.y, v1.y) };
-		min.x = std::min(min.x, v2.x);
-		min.y = std::min(min.y, v2.y);
+		return result;
+	};
 
-		dae::Vector2 max{ std::max(v0.x, v1.x),std::max(v0.y, v1.y) };
-		max.x = std::max(max.x, v2.x);
-		max.y = std::max(max.y, v2.y);
+	//Counters of the heatmap, only while one is shown
+	dae::Heatmap* pHeatmap{ m_pHeatmap };
+
+	for (const TriangleIndices& triangle : m_VisibleTriangles)
+	{
+		const uint32_t i0{ triangle.i0 };
+		const uint32_t i1{ triangle.i1 };
+		const uint32_t i2{ triangle.i2 };
+
+		const dae::Vector4& p0{ m_VerticesOut[i0].position };
+		const dae::Vector4& p1{ m_VerticesOut[i1].position };
+		const dae::Vector4& p2{ m_VerticesOut[i2].position };
+
+		//Triangle setup
+		dae::TriangleSetup setup{};
+		if (!setup.Setup(p0, p1, p2, width, height)) continue;
+
+		const int uvPlane{ setup.AddAttribute(m_VerticesOut[i0].uv, m_VerticesOut[i1].uv, m_VerticesOut[i2].uv) };
+		const int normalPlane{ setup.AddAttribute(m_VerticesOut[i0].normal, m_VerticesOut[i1].normal, m_VerticesOut[i2].normal) };
+		const int tangentPlane{ setup.AddAttribute(m_VerticesOut[i0].tangent, m_VerticesOut[i1].tangent, m_VerticesOut[i2].tangent) };
+		const int viewDirectionPlane{ setup.AddAttribute(m_VerticesOut[i0].viewDirection, m_VerticesOut[i1].viewDirection, m_VerticesOut[i2].viewDirection) };
+		const int previousPositionPlane{ useTemporalCache ? setup.AddAttribute(m_PreviousPositions[i0], m_PreviousPositions[i1], m_PreviousPositions[i2]) : 0 };
+		const dae::TriangleSamples<nrSamples> samples{ setup };
+
+		//Blocks of earlier triangles never match, the row of a block is below 2^20
+		const uint64_t triangleKey{ ++m_NrCoarseShadedTriangles << 20 };
 
 		//RENDER LOGIC
-		for (int px{ std::max(0,static_cast<int>(min.x)) }; px <= std::min(width - 1, static_cast<int>(max.x)); ++px)
+		for (int py{ setup.min.y }; py <= setup.max.y; ++py)
 		{
-			for (int py{ std::max(0,static_cast<int>(min.y)) }; py <= std::min(height - 1, static_cast<int>(max.y)); ++py)
+			dae::TriangleSpan span{};
+			span.Begin(setup, static_cast<float>(setup.min.x), static_cast<float>(py));
+
+			//The cycles of the row go to a tile whenever the row enters the next one
+			uint64_t tileStartCycles{ pHeatmap ? dae::Heatmap::GetCycles() : 0 };
+
+			for (int px{ setup.min.x }; px <= setup.max.x; ++px, span.Step(setup))
 			{
+				//Color and depth can be tiled, the pixel data of the mesh is linear
+				const int pixelIndex{ px + (py * width) };
+				const int bufferIndex{ layout.GetIndex(px, py) };
+
+				if (pHeatmap && px % dae::Heatmap::tileSize == 0 && px != setup.min.x)
+				{
+					const uint64_t cycles{ dae::Heatmap::GetCycles() };
+					pHeatmap->AddTileCycles(px - 1, py, cycles - tileStartCycles);
+					tileStartCycles = cycles;
+				}
+
 				// Boundingbox visualization
-				if (m_ShowBoundingbox)
+				if constexpr (showBoundingBox)
 				{
-					pBackBufferPixels[static_cast<int>(px) + (static_cast<int>(py) * width)] = SDL_MapRGB(pBackBuffer->format,
-						static_cast<uint8_t>(255),
-						static_cast<uint8_t>(255),
-						static_cast<uint8_t>(255));		
+					for (int sample{}; sample < nrSamples; ++sample)
+					{
+						pBackBufferPixels[sample * planeSize + bufferIndex] = SDL_MapRGB(pBackBuffer->format,
+							static_cast<uint8_t>(255),
+							static_cast<uint8_t>(255),
+							static_cast<uint8_t>(255));
+					}
 					continue;
 				}
 
-				//Rasterization
-				dae::Vector3 vertexRatio{};
-				if (!dae::Utils::IsPixelInTriangle(dae::Vector2{ static_cast<float>(px),static_cast<float>(py) }, v0, v1, v2, vertexRatio, shouldSwap)) continue;
+				//Rasterization, coverage and depth are tested per sample
+				const uint32_t coverage{ samples.GetCoverage(span) };
+				if (coverage == 0) continue;
 
-				//Attribute Interpolation
-				const float currentDepth{ 1.f / ((vertexRatio.x / m_VerticesOut[m_Indices[index]].position.z) + (vertexRatio.y / m_VerticesOut[m_Indices[index + 1]].position.z) + (vertexRatio.z / m_VerticesOut[m_Indices[index + 2]].position.z)) };
+				//The first visible fragment of the first sample covers the pixel (only this mesh writes depth)
+				const bool isUncovered{ pDepthBufferPixels[bufferIndex] == INFINITY };
+				const uint32_t visibleSamples{ samples.template DepthTest<true>(span, coverage, pDepthBufferPixels, bufferIndex, planeSize) };
 
-				if (currentDepth < pDepthBufferPixels[px + (py * width)])
+				if (pHeatmap)
 				{
-					pDepthBufferPixels[px + (py * width)] = currentDepth;
+					pHeatmap->AddDepthFails(pixelIndex, static_cast<uint32_t>(std::popcount(coverage & ~visibleSamples)));
+					if (visibleSamples != 0) pHeatmap->AddFragment(pixelIndex);
+				}
 
-					if (m_ShowDepth)
+				if (visibleSamples != 0)
+				{
+					if constexpr (showDepth)
 					{
 						continue;
 					}
 
-					const float wInterpolated{ 1.f / ((vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w) + (vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w) + (vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w)) };
+					++m_ShadingStatistics.nrVisiblePixels;
+					if (isUncovered && (visibleSamples & 0x01)) ++m_ShadingStatistics.nrCoveredPixels;
+
+					TemporalPixel* pCurrent{ nullptr };
+
+					const auto writeColor = [&](uint32_t color)
+					{
+						for (int sample{}; sample < nrSamples; ++sample)
+						{
+							if (visibleSamples >> sample & 0x01) pBackBufferPixels[sample * planeSize + bufferIndex] = color;
+						}
+
+						if (pCurrent) pCurrent->color = color;
+					};
+
+					//Temporal cache, the previous clip position is interpolated like any attribute and projected into the last frame.
+					//The color there is reused when it is the same surface (the depths match) and it is not too old.
+					//A mismatch (disocclusion, another surface) drops the history, so moving edges don't leave a trail
+					const TemporalPixel* pHistory{ nullptr };
+
+					if (useTemporalCache)
+					{
+						pCurrent = &m_Current[pixelIndex];
+						pCurrent->w = span.GetW();
+						pCurrent->age = 0;
+						pCurrent->nrAccumulated = 0;
+
+						const dae::Vector3 previousPosition{ span.GetVector3(previousPositionPlane, pCurrent->w) };
+
+						if (previousPosition.z > 0.f)
+						{
+							//Nearest pixel corner, colors are shaded around the corner
+							const float previousX{ 0.5f * (previousPosition.x / previousPosition.z + 1.f) * width + 0.5f };
+							const float previousY{ 0.5f * (1.f - previousPosition.y / previousPosition.z) * height + 0.5f };
+
+							if (previousX >= 0.f && previousX < width && previousY >= 0.f && previousY < height)
+							{
+								const TemporalPixel& history{ m_History[static_cast<int>(previousX) + static_cast<int>(previousY) * width] };
+
+								if (std::abs(history.w - previousPosition.z) < m_HistoryDepthTolerance * previousPosition.z)
+								{
+									pHistory = &history;
+								}
+							}
+						}
+
+						const bool isRefreshed{ ((px & 1) | (py & 1) << 1) == refreshQuadPixel };
+
+						if (pHistory && !isRefreshed && pHistory->age < m_MaxHistoryAge)
+						{
+							pCurrent->age = pHistory->age + 1;
+							pCurrent->nrAccumulated = pHistory->nrAccumulated;
+							writeColor(pHistory->color);
+
+							++m_ShadingStatistics.nrReprojectedPixels;
+							continue;
+						}
+					}
+
+					//Coarse shading, the first visible pixel of a block shades it for the rest of the block (in the same triangle)
+					CoarseShadingBlock* pBlock{ nullptr };
+
+					if (useCoarseShading)
+					{
+						const dae::Int2 blockSize{ isAdaptive ? m_pShadingRateImage->GetBlockSize(px, py) : uniformBlockSize };
+						const uint64_t key{ triangleKey | static_cast<uint64_t>(py - py % blockSize.y) };
+
+						pBlock = &m_CoarseShadingBlocks[px - px % blockSize.x];
+
+						if (pBlock->key == key)
+						{
+							writeColor(pBlock->color);
+							continue;
+						}
+
+						pBlock->key = key;
+					}
+
+					++m_ShadingStatistics.nrShadedPixels;
+					const uint64_t shadingStartCycles{ pHeatmap ? dae::Heatmap::GetCycles() : 0 };
+
+					//Attribute Interpolation, shaded once per pixel at its corner (jittered around it with the temporal cache)
+					const dae::TriangleSpan shadingSpan{ useTemporalCache ? span.GetOffset(setup, jitterX, jitterY) : span };
+					const float currentDepth{ shadingSpan.GetDepth() };
+					const float wInterpolated{ shadingSpan.GetW() };
 
 					VertexOut pixel
 					{
@@ -114,31 +402,102 @@ void MeshOpaque::SoftwareRender(int width, int height, SDL_Surface* pBackBuffer,
 							currentDepth,
 							wInterpolated
 						},
-						dae::Vector2 //uv
-						{
-							(m_Vertices[m_Indices[index]].uv * vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w + m_Vertices[m_Indices[index + 1]].uv * vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w + m_Vertices[m_Indices[index + 2]].uv * vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w) * wInterpolated
-						},
-						dae::Vector3 //normal
-						{
-							((m_VerticesOut[m_Indices[index]].normal * vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w + m_VerticesOut[m_Indices[index + 1]].normal * vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w + m_VerticesOut[m_Indices[index + 2]].normal * vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w) * wInterpolated).Normalized()
-						},
-						dae::Vector3 //tangent
-						{
-							((m_VerticesOut[m_Indices[index]].tangent * vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w + m_VerticesOut[m_Indices[index + 1]].tangent * vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w + m_VerticesOut[m_Indices[index + 2]].tangent * vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w) * wInterpolated).Normalized()
-						},
-						dae::Vector3 //viewDirection
-						{
-							((m_VerticesOut[m_Indices[index]].viewDirection * vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w + m_VerticesOut[m_Indices[index + 1]].viewDirection * vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w + m_VerticesOut[m_Indices[index + 2]].viewDirection * vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w) * wInterpolated).Normalized()
-						}
+						shadingSpan.GetVector2(uvPlane, wInterpolated), //uv
+						shadingSpan.GetVector3(normalPlane, wInterpolated), //normal
+						shadingSpan.GetVector3(tangentPlane, wInterpolated), //tangent
+						m_VerticesOut[i0].handedness, //handedness, constant over a triangle
+						shadingSpan.GetVector3(viewDirectionPlane, wInterpolated) //viewDirection
 					};
 
-					pEffect->PixelShading(pixel, width, height, pBackBuffer, pBackBufferPixels, m_UseNormalMap, m_RenderMode);
+					if constexpr (shadingQuality == ShadingQuality::Fast)
+					{
+						pixel.normal = dae::FastMath::Normalized(pixel.normal);
+						pixel.tangent = dae::FastMath::Normalized(pixel.tangent);
+						pixel.viewDirection = dae::FastMath::Normalized(pixel.viewDirection);
+					}
+					else
+					{
+						pixel.normal.Normalize();
+						pixel.tangent.Normalize();
+						pixel.viewDirection.Normalize();
+					}
+
+					uint32_t color{ pEffect->PixelShading<useNormalMap, renderMode, shadingQuality>(pixel, pBackBuffer->format) };
+					if (pBlock) pBlock->color = color;
+
+					//Accumulated with the history of the same surface
+					if (pHistory)
+					{
+						const uint32_t nrHistoryShadings{ std::min(pHistory->nrAccumulated, m_MaxAccumulatedShadings - 1) };
+
+						color = accumulateColor(pHistory->color, color, nrHistoryShadings);
+						pCurrent->nrAccumulated = nrHistoryShadings + 1;
+					}
+					else if (pCurrent)
+					{
+						pCurrent->nrAccumulated = 1;
+					}
+
+					writeColor(color);
+
+					if (pHeatmap) pHeatmap->AddShadingCycles(pixelIndex, dae::Heatmap::GetCycles() - shadingStartCycles);
 				}
 			}
+
+			if (pHeatmap) pHeatmap->AddTileCycles(setup.max.x, py, dae::Heatmap::GetCycles() - tileStartCycles);
 		}
 	}
 }
 
+template<int nrSamples>
+MeshOpaque::RasterizeFunction MeshOpaque::SelectRasterizeFunction() const
+{
+	//The debug views don't shade, so they don't need a permutation per shading mode
+	if (m_ShowBoundingbox)
+	{
+		return &MeshOpaque::RasterizeTriangles<nrSamples, true, false, false, RenderMode::Combined, ShadingQuality::Precise>;
+	}
+
+	if (m_ShowDepth)
+	{
+		return &MeshOpaque::RasterizeTriangles<nrSamples, false, true, false, RenderMode::Combined, ShadingQuality::Precise>;
+	}
+
+	switch (static_cast<EffectOpaque*>(m_pEffect.get())->GetShadingQuality())
+	{
+	case ShadingQuality::Fast:
+		return m_UseNormalMap ? SelectShadingFunction<nrSamples, true, ShadingQuality::Fast>() : SelectShadingFunction<nrSamples, false, ShadingQuality::Fast>();
+	case ShadingQuality::LookupTable:
+		return m_UseNormalMap ? SelectShadingFunction<nrSamples, true, ShadingQuality::LookupTable>() : SelectShadingFunction<nrSamples, false, ShadingQuality::LookupTable>();
+	default:
+	case ShadingQuality::Precise:
+		return m_UseNormalMap ? SelectShadingFunction<nrSamples, true, ShadingQuality::Precise>() : SelectShadingFunction<nrSamples, false, ShadingQuality::Precise>();
+	}
+}
+
+template<int nrSamples, bool useNormalMap, ShadingQuality shadingQuality>
+MeshOpaque::RasterizeFunction MeshOpaque::SelectShadingFunction() const
+{
+	switch (m_RenderMode)
+	{
+	case RenderMode::ObservedArea:
+		return &MeshOpaque::RasterizeTriangles<nrSamples, false, false, useNormalMap, RenderMode::ObservedArea, shadingQuality>;
+	case RenderMode::Diffuse:
+		return &MeshOpaque::RasterizeTriangles<nrSamples, false, false, useNormalMap, RenderMode::Diffuse, shadingQuality>;
+	case RenderMode::Specular:
+		return &MeshOpaque::RasterizeTriangles<nrSamples, false, false, useNormalMap, RenderMode::Specular, shadingQuality>;
+	default:
+	case RenderMode::Combined:
+		return &MeshOpaque::RasterizeTriangles<nrSamples, false, false, useNormalMap, RenderMode::Combined, shadingQuality>;
+	}
+}
+
+size_t MeshOpaque::GetMemoryUsage() const
+{
+	return Mesh::GetMemoryUsage()
+		+ (m_History.capacity() + m_Current.capacity()) * sizeof(TemporalPixel);
+}
+
 void MeshOpaque::PrintTypeName()
 {
 	std::cout << "----------------------------\n";
@@ -182,4 +541,29 @@ void MeshOpaque::SetRenderMode(RenderMode renderMode)
 	m_RenderMode = renderMode;
 }
 
+void MeshOpaque::SetShadingRate(ShadingRate shadingRate)
+{
+	m_ShadingRate = shadingRate;
+}
+
+void MeshOpaque::SetShadingRateImage(const dae::ShadingRateImage* pShadingRateImage)
+{
+	m_pShadingRateImage = pShadingRateImage;
+}
+
+const ShadingStatistics& MeshOpaque::GetShadingStatistics() const
+{
+	return m_ShadingStatistics;
+}
+
+void MeshOpaque::SetShadingQuality(ShadingQuality shadingQuality)
+{
+	static_cast<EffectOpaque*>(m_pEffect.get())->SetShadingQuality(shadingQuality);
+}
+
+void MeshOpaque::SetUseTemporalCache(bool useTemporalCache)
+{
+	m_UseTemporalCache = useTemporalCache;
+}
+
 
@@ -5,6 +5,18 @@
 #include "Mesh.h"
 class Effect;
 class Texture;
+namespace dae
+{
+	class ShadingRateImage;
+}
+
+struct ShadingStatistics
+{
+	uint32_t nrVisiblePixels{};
+	uint32_t nrCoveredPixels{}; //Pixels on screen, nrVisiblePixels / nrCoveredPixels is the overdraw
+	uint32_t nrShadedPixels{};
+	uint32_t nrReprojectedPixels{};
+};
 
 
 //-----------------------------------------------------
@@ -13,7 +25,7 @@ class Texture;
 class MeshOpaque final : public Mesh
 {
 public:
-	MeshOpaque(ID3D11Device* pDevice, const std::string& filename, Texture* pDiffuseMap, Texture* pNormalMap, Texture* pSpecularMap, Texture* pGlossinessMap);
+	MeshOpaque(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat, Texture* pDiffuseMap, Texture* pNormalMap, Texture* pSpecularMap, Texture* pGlossinessMap);
 	~MeshOpaque() = default;
 
 	// -------------------------
@@ -27,8 +39,9 @@ public:
 	//-------------------------------------------------
 	// Member functions						
 	//-------------------------------------------------
-	virtual void SoftwareRender(int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels) override;
+	virtual void SoftwareRender(const dae::FrameBufferLayout& layout, int nrSamples, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels, dae::FrameArena& frameArena) override;
 	virtual void PrintTypeName() override;
+	virtual size_t GetMemoryUsage() const override;
 
 	void SetDiffuseMap(Texture* pDiffuseMap);
 	void SetNormalMap(Texture* pNormalMap);
@@ -39,7 +52,80 @@ public:
 	void SetUseNormalMap(bool useNormalMap);
 	void SetRenderMode(RenderMode renderMode);
 
+	//Software only, depth and coverage stay per pixel. Adaptive uses the rates of the image, which has to outlive the mesh
+	void SetShadingRate(ShadingRate shadingRate);
+	void SetShadingRateImage(const dae::ShadingRateImage* pShadingRateImage);
+	const ShadingStatistics& GetShadingStatistics() const;
+	void SetShadingQuality(ShadingQuality shadingQuality);
+
+	//Software only, reuses the colors of the last frame where the same surface was visible (see RasterizeTriangles)
+	void SetUseTemporalCache(bool useTemporalCache);
+
 private:
+	//-------------------------------------------------
+	// Private member functions								
+	//-------------------------------------------------
+	using RasterizeFunction = void (MeshOpaque::*)(const dae::FrameBufferLayout&, SDL_Surface*, uint32_t*, float*);
+
+	template<int nrSamples, bool showBoundingBox, bool showDepth, bool useNormalMap, RenderMode renderMode, ShadingQuality shadingQuality>
+	void RasterizeTriangles(const dae::FrameBufferLayout& layout, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels);
+
+	template<int nrSamples>
+	RasterizeFunction SelectRasterizeFunction() const;
+
+	template<int nrSamples, bool useNormalMap, ShadingQuality shadingQuality>
+	RasterizeFunction SelectShadingFunction() const;
+
+	//Clip space x, y and w of the vertices in the last frame, the motion of the instance and the camera
+	template<typename VertexType>
+	void TransformPreviousPositions(const std::vector<VertexType>& vertices, const dae::Matrix& previousWorldViewProjection, std::span<dae::Vector3> previousPositions);
+	void BeginTemporalFrame(int width, int height, RasterizeFunction rasterizeFunction);
+
+	//-------------------------------------------------
+	// Datamembers								
+	//-------------------------------------------------
 	bool m_UseNormalMap{ true };
 	RenderMode m_RenderMode{ RenderMode::Combined };
+
+	//Coarse shading, the last shaded block per start column. Only blocks of the current triangle (and row) are reused
+	struct CoarseShadingBlock
+	{
+		uint64_t key{};
+		uint32_t color{};
+	};
+
+	ShadingRate m_ShadingRate{ ShadingRate::Rate1x1 };
+	const dae::ShadingRateImage* m_pShadingRateImage{};
+	std::span<CoarseShadingBlock> m_CoarseShadingBlocks{}; //Frame arena memory
+	uint64_t m_NrCoarseShadedTriangles{};
+	ShadingStatistics m_ShadingStatistics{};
+
+	//Temporal cache, what the mesh wrote to every pixel in the last and in the current frame
+	struct TemporalPixel
+	{
+		uint32_t color{};
+		float w{}; //View depth, 0 where the mesh was not visible
+		uint32_t age{}; //Frames since the color was shaded
+		uint32_t nrAccumulated{}; //Jittered shadings averaged into the color, up to m_MaxAccumulatedShadings
+	};
+
+	bool m_UseTemporalCache{ false };
+	std::vector<TemporalPixel> m_History{};
+	std::vector<TemporalPixel> m_Current{};
+	std::span<dae::Vector3> m_BatchPreviousPositions{}; //Frame arena memory, like m_BatchVerticesOut
+	std::span<dae::Vector3> m_PreviousPositions{}; //The instance that is rasterized
+	int m_HistoryWidth{};
+	int m_HistoryHeight{};
+	RasterizeFunction m_HistoryRasterizeFunction{};
+	uint32_t m_TemporalFrame{};
+
+	//Matrices the history was rendered with
+	dae::Matrix m_PreviousWorldMatrix{};
+	dae::Matrix m_PreviousViewProjectionMatrix{};
+
+	//Every pixel is reshaded at least once in this many frames, a reprojected depth has to match within this fraction
+	static constexpr uint32_t m_MaxHistoryAge{ 4 };
+	static constexpr float m_HistoryDepthTolerance{ 0.02f };
+	//A reshaded pixel is averaged with its history (if the depth matches), the oldest shading weighs at least 1 / this many
+	static constexpr uint32_t m_MaxAccumulatedShadings{ 4 };
 };
\ No newline at end of file
@@ -0,0 +1,258 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include <array>
+#include <bit>
+#include <unordered_map>
+#include "Mesh.h"
+
+namespace
+{
+	//Exact bits of every attribute of a vertex
+	struct VertexKey
+	{
+		uint32_t bits[12]{};
+
+		explicit VertexKey(const Vertex& vertex)
+		{
+			const float values[12]
+			{
+				vertex.position.x, vertex.position.y, vertex.position.z,
+				vertex.uv.x, vertex.uv.y,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z,
+				vertex.tangent.x, vertex.tangent.y, vertex.tangent.z,
+				vertex.handedness
+			};
+
+			for (int index{}; index < 12; ++index)
+			{
+				bits[index] = std::bit_cast<uint32_t>(values[index]);
+			}
+		}
+
+		bool operator==(const VertexKey& other) const
+		{
+			return std::equal(std::begin(bits), std::end(bits), std::begin(other.bits));
+		}
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			//FNV-1a
+			size_t hash{ 14695981039346656037ull };
+			for (uint32_t bits : key.bits)
+			{
+				hash = (hash ^ bits) * 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+
+	using Triangle = std::array<uint32_t, 3>;
+
+	class Stripifier final
+	{
+	public:
+		explicit Stripifier(const uint32_t* pIndices, size_t nrIndices)
+		{
+			m_Triangles.reserve(nrIndices / 3);
+			for (size_t index{}; index + 2 < nrIndices; index += 3)
+			{
+				m_Triangles.push_back({ pIndices[index], pIndices[index + 1], pIndices[index + 2] });
+			}
+
+			m_IsUsed.resize(m_Triangles.size());
+			m_Stamps.resize(m_Triangles.size());
+
+			//Directed edges in winding order, sorted so the triangles with an edge can be found with a binary search
+			m_Edges.reserve(m_Triangles.size() * 3);
+			for (uint32_t triangle{}; triangle < m_Triangles.size(); ++triangle)
+			{
+				for (int corner{}; corner < 3; ++corner)
+				{
+					m_Edges.push_back({ GetEdgeKey(m_Triangles[triangle][corner], m_Triangles[triangle][(corner + 1) % 3]), triangle });
+				}
+			}
+
+			std::sort(m_Edges.begin(), m_Edges.end());
+		}
+
+		std::vector<uint32_t> CreateStrips()
+		{
+			std::vector<uint32_t> strips{};
+			strips.reserve(m_Triangles.size() * 2);
+
+			std::vector<uint32_t> strip{};
+			std::vector<uint32_t> bestStrip{};
+			std::vector<uint32_t> stripTriangles{};
+			std::vector<uint32_t> bestStripTriangles{};
+
+			for (uint32_t start{}; start < m_Triangles.size(); ++start)
+			{
+				if (m_IsUsed[start]) continue;
+
+				//Every rotation of the first triangle grows in another direction, keep the longest
+				bestStrip.clear();
+
+				for (int rotation{}; rotation < 3; ++rotation)
+				{
+					GrowStrip(start, rotation, strip, stripTriangles);
+
+					if (strip.size() > bestStrip.size())
+					{
+						std::swap(strip, bestStrip);
+						std::swap(stripTriangles, bestStripTriangles);
+					}
+				}
+
+				for (uint32_t triangle : bestStripTriangles)
+				{
+					m_IsUsed[triangle] = true;
+				}
+
+				//Cut, and pad so the strip starts at an even offset
+				if (!strips.empty())
+				{
+					strips.push_back(dae::Utils::stripRestartIndex);
+					if (strips.size() & 0x01) strips.push_back(dae::Utils::stripRestartIndex);
+				}
+
+				strips.insert(strips.end(), bestStrip.begin(), bestStrip.end());
+			}
+
+			return strips;
+		}
+
+	private:
+		void GrowStrip(uint32_t start, int rotation, std::vector<uint32_t>& strip, std::vector<uint32_t>& stripTriangles)
+		{
+			//Triangles of this attempt are stamped, so a strip never uses a triangle twice
+			++m_Stamp;
+
+			const Triangle& first{ m_Triangles[start] };
+			strip.assign({ first[rotation], first[(rotation + 1) % 3], first[(rotation + 2) % 3] });
+			stripTriangles.assign({ start });
+			m_Stamps[start] = m_Stamp;
+
+			while (true)
+			{
+				//The next triangle shares the last edge, odd triangles of a strip have the opposite winding
+				const uint32_t p{ strip[strip.size() - 2] };
+				const uint32_t q{ strip[strip.size() - 1] };
+				const bool isNextOdd{ (strip.size() - 2) & 0x01 };
+
+				uint32_t third{};
+				const uint32_t next{ isNextOdd ? FindTriangle(q, p, third) : FindTriangle(p, q, third) };
+				if (next == UINT32_MAX) break;
+
+				strip.push_back(third);
+				stripTriangles.push_back(next);
+				m_Stamps[next] = m_Stamp;
+			}
+		}
+
+		//Unused triangle with the directed edge from -> to, outputs its third corner
+		uint32_t FindTriangle(uint32_t from, uint32_t to, uint32_t& third) const
+		{
+			const uint64_t key{ GetEdgeKey(from, to) };
+
+			auto it{ std::lower_bound(m_Edges.begin(), m_Edges.end(), std::pair<uint64_t, uint32_t>{ key, 0 }) };
+
+			for (; it != m_Edges.end() && it->first == key; ++it)
+			{
+				const uint32_t triangle{ it->second };
+				if (m_IsUsed[triangle] || m_Stamps[triangle] == m_Stamp) continue;
+
+				for (uint32_t corner : m_Triangles[triangle])
+				{
+					if (corner != from && corner != to)
+					{
+						third = corner;
+						return triangle;
+					}
+				}
+			}
+
+			return UINT32_MAX;
+		}
+
+		static uint64_t GetEdgeKey(uint32_t from, uint32_t to)
+		{
+			return (static_cast<uint64_t>(from) << 32) | to;
+		}
+
+		std::vector<Triangle> m_Triangles{};
+		std::vector<std::pair<uint64_t, uint32_t>> m_Edges{};
+		std::vector<bool> m_IsUsed{};
+		std::vector<uint32_t> m_Stamps{};
+		uint32_t m_Stamp{};
+	};
+}
+
+namespace dae
+{
+	namespace Utils
+	{
+		void WeldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			std::unordered_map<VertexKey, uint32_t, VertexKeyHash> indexOfKey{};
+			indexOfKey.reserve(vertices.size());
+
+			std::vector<uint32_t> newIndexOf(vertices.size());
+			std::vector<Vertex> weldedVertices{};
+			weldedVertices.reserve(vertices.size());
+
+			for (size_t index{}; index < vertices.size(); ++index)
+			{
+				const auto result{ indexOfKey.try_emplace(VertexKey{ vertices[index] }, static_cast<uint32_t>(weldedVertices.size())) };
+				if (result.second) weldedVertices.push_back(vertices[index]);
+
+				newIndexOf[index] = result.first->second;
+			}
+
+			for (uint32_t& index : indices)
+			{
+				index = newIndexOf[index];
+			}
+
+			vertices = std::move(weldedVertices);
+		}
+
+		void GenerateStrips(MeshData& meshData)
+		{
+			if (meshData.topology != PrimitiveTopology::TriangleList) return;
+
+			std::vector<MeshLOD> lods{ meshData.lods };
+			if (lods.empty())
+			{
+				lods.push_back({ 0, static_cast<uint32_t>(meshData.indices.size()), static_cast<uint32_t>(meshData.vertices.size()) });
+			}
+
+			std::vector<uint32_t> indices{};
+
+			for (MeshLOD& lod : lods)
+			{
+				const std::vector<uint32_t> strips{ Stripifier{ meshData.indices.data() + lod.firstIndex, lod.nrIndices }.CreateStrips() };
+
+				lod.firstIndex = static_cast<uint32_t>(indices.size());
+				lod.nrIndices = static_cast<uint32_t>(strips.size());
+
+				indices.insert(indices.end(), strips.begin(), strips.end());
+
+				//Keep every level at an even offset, the winding of a strip triangle depends on it
+				if (indices.size() & 0x01) indices.push_back(stripRestartIndex);
+			}
+
+			//Strips only pay off when the triangles share enough edges
+			if (indices.size() >= meshData.indices.size()) return;
+
+			meshData.indices = std::move(indices);
+			meshData.topology = PrimitiveTopology::TriangleStrip;
+			if (!meshData.lods.empty()) meshData.lods = std::move(lods);
+		}
+	}
+}
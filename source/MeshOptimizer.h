@@ -0,0 +1,23 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+struct Vertex;
+struct MeshData;
+
+namespace dae
+{
+	namespace Utils
+	{
+		//Index of the cuts between triangle strips, D3D11 cuts on all ones for both index formats
+		constexpr uint32_t stripRestartIndex{ UINT32_MAX };
+
+		//Merges vertices with identical attributes, the OBJ loader creates one vertex per face corner
+		void WeldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		//Converts every level of detail to triangle strips when that takes fewer indices than the triangle list.
+		//Strips are grown greedily over shared edges and separated by restart indices.
+		//Every strip starts at an even offset from the start of its level (an extra cut pads it), so the winding of a triangle only depends on its offset.
+		void GenerateStrips(MeshData& meshData);
+	}
+}
@@ -0,0 +1,539 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "MeshSimplifier.h"
+#include <array>
+#include <bit>
+#include <queue>
+#include <unordered_map>
+#include "Mesh.h"
+
+namespace
+{
+	//Sum of squared distances to a set of planes, weighted by the area of the triangles they belong to
+	struct Quadric
+	{
+		double a00{}, a01{}, a02{}, a03{};
+		double a11{}, a12{}, a13{};
+		double a22{}, a23{};
+		double a33{};
+		double weight{};
+
+		static Quadric FromPlane(const dae::Vector3& normal, float distance, double weight)
+		{
+			const double a{ normal.x }, b{ normal.y }, c{ normal.z }, d{ distance };
+
+			return
+			{
+				a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+				b * b * weight, b * c * weight, b * d * weight,
+				c * c * weight, c * d * weight,
+				d * d * weight,
+				weight
+			};
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+			weight += other.weight;
+			return *this;
+		}
+
+		//Mean squared distance of the point to the planes
+		double Evaluate(const dae::Vector3& point) const
+		{
+			const double x{ point.x }, y{ point.y }, z{ point.z };
+
+			const double error
+			{
+				a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+				+ a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+				+ a22 * z * z + 2.0 * a23 * z
+				+ a33
+			};
+
+			return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+		}
+	};
+
+	//Moves every vertex at the position of group "from" onto a vertex of group "to"
+	struct Collapse
+	{
+		double cost{};
+		uint32_t from{};
+		uint32_t to{};
+		uint32_t fromVersion{};
+		uint32_t toVersion{};
+
+		bool operator>(const Collapse& other) const
+		{
+			return cost > other.cost;
+		}
+	};
+
+	using Triangle = std::array<uint32_t, 3>;
+
+	//Hashes the exact bits of a number of floats, used to weld vertices
+	template<size_t nrFloats>
+	struct FloatKey
+	{
+		uint32_t bits[nrFloats]{};
+
+		bool operator==(const FloatKey& other) const
+		{
+			return std::equal(std::begin(bits), std::end(bits), std::begin(other.bits));
+		}
+
+		struct Hash
+		{
+			size_t operator()(const FloatKey& key) const
+			{
+				//FNV-1a
+				size_t hash{ 14695981039346656037ull };
+				for (uint32_t bits : key.bits)
+				{
+					hash = (hash ^ bits) * 1099511628211ull;
+				}
+				return hash;
+			}
+		};
+	};
+
+	template<size_t nrFloats>
+	FloatKey<nrFloats> MakeKey(const float* pValues)
+	{
+		FloatKey<nrFloats> key{};
+		for (size_t index{}; index < nrFloats; ++index)
+		{
+			key.bits[index] = pValues[index] == 0.f ? 0u : std::bit_cast<uint32_t>(pValues[index]);
+		}
+		return key;
+	}
+
+	//Every level should remove at least a quarter of the triangles of the level before, otherwise it is not worth a draw
+	constexpr float minReduction{ 0.75f };
+
+	//Stop collapsing once the mean squared distance to the original surface exceeds this fraction of the bounding radius (squared)
+	constexpr float maxRelativeError{ 0.05f };
+
+	class Simplifier final
+	{
+	public:
+		Simplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+			:m_Vertices{ vertices }
+		{
+			Weld();
+			CreateTriangles(indices);
+			CreateQuadrics();
+			LockBorders();
+		}
+
+		//Collapses until the triangle count reaches each target, every target that is reached adds a level
+		std::vector<std::vector<uint32_t>> Simplify(const std::vector<size_t>& targets, double maxError)
+		{
+			std::vector<std::vector<uint32_t>> levels{};
+			if (targets.empty()) return levels;
+
+			for (const auto& [edge, count] : m_EdgeCounts)
+			{
+				PushCollapse(static_cast<uint32_t>(edge >> 32), static_cast<uint32_t>(edge));
+				PushCollapse(static_cast<uint32_t>(edge), static_cast<uint32_t>(edge >> 32));
+			}
+
+			size_t lastNrTriangles{ m_NrLiveTriangles };
+			size_t target{};
+
+			while (target < targets.size() && !m_Collapses.empty())
+			{
+				const Collapse collapse{ m_Collapses.top() };
+				m_Collapses.pop();
+
+				if (collapse.cost > maxError) break;
+				if (m_IsDead[collapse.from] || m_IsDead[collapse.to]) continue;
+				if (collapse.fromVersion != m_Versions[collapse.from] || collapse.toVersion != m_Versions[collapse.to]) continue;
+
+				if (!TryCollapse(collapse.from, collapse.to)) continue;
+
+				if (m_NrLiveTriangles <= targets[target])
+				{
+					levels.push_back(GetIndices());
+					lastNrTriangles = m_NrLiveTriangles;
+
+					while (target < targets.size() && m_NrLiveTriangles <= targets[target])
+					{
+						++target;
+					}
+				}
+			}
+
+			//The error limit was hit before the next target, keep the result if it still saves enough
+			if (target < targets.size() && m_NrLiveTriangles < lastNrTriangles * minReduction)
+			{
+				levels.push_back(GetIndices());
+			}
+
+			return levels;
+		}
+
+	private:
+		void Weld()
+		{
+			const size_t nrVertices{ m_Vertices.size() };
+
+			m_WedgeOf.resize(nrVertices);
+			m_GroupOf.resize(nrVertices);
+			m_WedgesOfGroup.resize(nrVertices);
+			m_TrianglesOfGroup.resize(nrVertices);
+			m_Quadrics.resize(nrVertices);
+			m_Versions.resize(nrVertices);
+			m_IsDead.resize(nrVertices);
+			m_IsLocked.resize(nrVertices);
+
+			//Wedges: vertices with identical attributes. The loader already welds them (WeldVertices), meshes from elsewhere may not be
+			//Groups: wedges at the same position, separated by uv or normal seams
+			std::unordered_map<FloatKey<12>, uint32_t, FloatKey<12>::Hash> wedges{};
+			std::unordered_map<FloatKey<3>, uint32_t, FloatKey<3>::Hash> groups{};
+			wedges.reserve(nrVertices);
+			groups.reserve(nrVertices);
+
+			for (uint32_t index{}; index < nrVertices; ++index)
+			{
+				const Vertex& vertex{ m_Vertices[index] };
+
+				const float attributes[12]
+				{
+					vertex.position.x, vertex.position.y, vertex.position.z,
+					vertex.uv.x, vertex.uv.y,
+					vertex.normal.x, vertex.normal.y, vertex.normal.z,
+					vertex.tangent.x, vertex.tangent.y, vertex.tangent.z,
+					vertex.handedness
+				};
+
+				const auto wedge{ wedges.try_emplace(MakeKey<12>(attributes), index) };
+				m_WedgeOf[index] = wedge.first->second;
+
+				if (!wedge.second) continue;
+
+				const auto group{ groups.try_emplace(MakeKey<3>(attributes), index) };
+				m_GroupOf[index] = group.first->second;
+				m_WedgesOfGroup[group.first->second].push_back(index);
+			}
+		}
+
+		void CreateTriangles(const std::vector<uint32_t>& indices)
+		{
+			m_Triangles.reserve(indices.size() / 3);
+
+			for (size_t index{}; index + 2 < indices.size(); index += 3)
+			{
+				const Triangle triangle{ m_WedgeOf[indices[index]], m_WedgeOf[indices[index + 1]], m_WedgeOf[indices[index + 2]] };
+
+				const uint32_t group0{ m_GroupOf[triangle[0]] };
+				const uint32_t group1{ m_GroupOf[triangle[1]] };
+				const uint32_t group2{ m_GroupOf[triangle[2]] };
+
+				//Degenerate triangles are only kept in the full detail level
+				if (group0 == group1 || group0 == group2 || group1 == group2) continue;
+
+				const uint32_t triangleIndex{ static_cast<uint32_t>(m_Triangles.size()) };
+				m_Triangles.push_back(triangle);
+				m_IsTriangleDead.push_back(false);
+
+				for (uint32_t group : { group0, group1, group2 })
+				{
+					m_TrianglesOfGroup[group].push_back(triangleIndex);
+				}
+
+				++m_EdgeCounts[GetEdgeKey(group0, group1)];
+				++m_EdgeCounts[GetEdgeKey(group1, group2)];
+				++m_EdgeCounts[GetEdgeKey(group2, group0)];
+			}
+
+			m_NrLiveTriangles = m_Triangles.size();
+		}
+
+		void CreateQuadrics()
+		{
+			for (const Triangle& triangle : m_Triangles)
+			{
+				const dae::Vector3& p0{ m_Vertices[triangle[0]].position };
+				const dae::Vector3 normal{ GetNormal(triangle, triangle[0], p0) };
+
+				const float doubleArea{ normal.Magnitude() };
+				if (doubleArea == 0.f) continue;
+
+				const dae::Vector3 unitNormal{ normal / doubleArea };
+				const Quadric quadric{ Quadric::FromPlane(unitNormal, -dae::Vector3::Dot(unitNormal, p0), 0.5 * doubleArea) };
+
+				for (uint32_t wedge : triangle)
+				{
+					m_Quadrics[m_GroupOf[wedge]] += quadric;
+				}
+			}
+		}
+
+		//Edges with one triangle are on a border, edges with more than two are not manifold, both keep their shape
+		void LockBorders()
+		{
+			for (const auto& [edge, count] : m_EdgeCounts)
+			{
+				if (count == 2) continue;
+
+				m_IsLocked[static_cast<uint32_t>(edge >> 32)] = true;
+				m_IsLocked[static_cast<uint32_t>(edge)] = true;
+			}
+		}
+
+		void PushCollapse(uint32_t from, uint32_t to)
+		{
+			if (m_IsLocked[from]) return;
+
+			Quadric quadric{ m_Quadrics[from] };
+			quadric += m_Quadrics[to];
+
+			m_Collapses.push({ quadric.Evaluate(m_Vertices[to].position), from, to, m_Versions[from], m_Versions[to] });
+		}
+
+		bool TryCollapse(uint32_t from, uint32_t to)
+		{
+			//Every wedge of "from" has to move onto a wedge of "to" it shares an edge with, so seams stay intact
+			m_WedgeMapping.clear();
+
+			for (uint32_t wedge : m_WedgesOfGroup[from])
+			{
+				uint32_t target{ UINT32_MAX };
+
+				for (uint32_t triangleIndex : m_TrianglesOfGroup[from])
+				{
+					if (m_IsTriangleDead[triangleIndex]) continue;
+
+					const Triangle& triangle{ m_Triangles[triangleIndex] };
+					if (std::find(triangle.begin(), triangle.end(), wedge) == triangle.end()) continue;
+
+					for (uint32_t corner : triangle)
+					{
+						if (m_GroupOf[corner] == to)
+						{
+							target = corner;
+							break;
+						}
+					}
+
+					if (target != UINT32_MAX) break;
+				}
+
+				if (target == UINT32_MAX) return false;
+				m_WedgeMapping.emplace_back(wedge, target);
+			}
+
+			//The triangles that remain must not flip
+			const dae::Vector3& newPosition{ m_Vertices[to].position };
+
+			for (uint32_t triangleIndex : m_TrianglesOfGroup[from])
+			{
+				if (m_IsTriangleDead[triangleIndex] || ContainsGroup(m_Triangles[triangleIndex], to)) continue;
+
+				const Triangle& triangle{ m_Triangles[triangleIndex] };
+				const uint32_t movedWedge{ *std::find_if(triangle.begin(), triangle.end(), [this, from](uint32_t wedge) { return m_GroupOf[wedge] == from; }) };
+
+				const dae::Vector3 oldNormal{ GetNormal(triangle, movedWedge, m_Vertices[movedWedge].position) };
+				const dae::Vector3 newNormal{ GetNormal(triangle, movedWedge, newPosition) };
+
+				if (dae::Vector3::Dot(oldNormal, newNormal) <= 0.f) return false;
+			}
+
+			//Apply
+			std::vector<uint32_t>& trianglesOfTo{ m_TrianglesOfGroup[to] };
+
+			for (uint32_t triangleIndex : m_TrianglesOfGroup[from])
+			{
+				if (m_IsTriangleDead[triangleIndex]) continue;
+
+				Triangle& triangle{ m_Triangles[triangleIndex] };
+
+				if (ContainsGroup(triangle, to))
+				{
+					m_IsTriangleDead[triangleIndex] = true;
+					--m_NrLiveTriangles;
+					continue;
+				}
+
+				for (uint32_t& corner : triangle)
+				{
+					for (const auto& [wedge, target] : m_WedgeMapping)
+					{
+						if (corner == wedge) corner = target;
+					}
+				}
+
+				trianglesOfTo.push_back(triangleIndex);
+			}
+
+			trianglesOfTo.erase(std::remove_if(trianglesOfTo.begin(), trianglesOfTo.end(), [this](uint32_t triangleIndex) { return m_IsTriangleDead[triangleIndex]; }), trianglesOfTo.end());
+
+			m_Quadrics[to] += m_Quadrics[from];
+			m_IsDead[from] = true;
+			m_TrianglesOfGroup[from].clear();
+			++m_Versions[to];
+
+			//Every collapse that involves "to" has a new cost
+			for (uint32_t triangleIndex : trianglesOfTo)
+			{
+				for (uint32_t corner : m_Triangles[triangleIndex])
+				{
+					const uint32_t neighbour{ m_GroupOf[corner] };
+					if (neighbour == to) continue;
+
+					PushCollapse(to, neighbour);
+					PushCollapse(neighbour, to);
+				}
+			}
+
+			return true;
+		}
+
+		std::vector<uint32_t> GetIndices() const
+		{
+			std::vector<uint32_t> indices{};
+			indices.reserve(m_NrLiveTriangles * 3);
+
+			for (size_t triangleIndex{}; triangleIndex < m_Triangles.size(); ++triangleIndex)
+			{
+				if (m_IsTriangleDead[triangleIndex]) continue;
+				indices.insert(indices.end(), m_Triangles[triangleIndex].begin(), m_Triangles[triangleIndex].end());
+			}
+
+			return indices;
+		}
+
+		bool ContainsGroup(const Triangle& triangle, uint32_t group) const
+		{
+			return m_GroupOf[triangle[0]] == group || m_GroupOf[triangle[1]] == group || m_GroupOf[triangle[2]] == group;
+		}
+
+		//Normal (not normalized) of the triangle with the given corner moved to position
+		dae::Vector3 GetNormal(const Triangle& triangle, uint32_t corner, const dae::Vector3& position) const
+		{
+			const dae::Vector3& p0{ triangle[0] == corner ? position : m_Vertices[triangle[0]].position };
+			const dae::Vector3& p1{ triangle[1] == corner ? position : m_Vertices[triangle[1]].position };
+			const dae::Vector3& p2{ triangle[2] == corner ? position : m_Vertices[triangle[2]].position };
+
+			return dae::Vector3::Cross(p1 - p0, p2 - p0);
+		}
+
+		static uint64_t GetEdgeKey(uint32_t group0, uint32_t group1)
+		{
+			return (static_cast<uint64_t>(std::min(group0, group1)) << 32) | std::max(group0, group1);
+		}
+
+		const std::vector<Vertex>& m_Vertices;
+
+		std::vector<uint32_t> m_WedgeOf{};
+		std::vector<uint32_t> m_GroupOf{};
+		std::vector<std::vector<uint32_t>> m_WedgesOfGroup{};
+		std::vector<std::vector<uint32_t>> m_TrianglesOfGroup{};
+
+		std::vector<Triangle> m_Triangles{};
+		std::vector<bool> m_IsTriangleDead{};
+		size_t m_NrLiveTriangles{};
+
+		std::unordered_map<uint64_t, int> m_EdgeCounts{};
+
+		std::vector<Quadric> m_Quadrics{};
+		std::vector<uint32_t> m_Versions{};
+		std::vector<bool> m_IsDead{};
+		std::vector<bool> m_IsLocked{};
+
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_Collapses{};
+		std::vector<std::pair<uint32_t, uint32_t>> m_WedgeMapping{};
+	};
+}
+
+namespace dae
+{
+	namespace Utils
+	{
+		void GenerateLODs(MeshData& meshData, int maxNrLODs)
+		{
+			std::vector<Vertex>& vertices{ meshData.vertices };
+			std::vector<uint32_t>& indices{ meshData.indices };
+
+			const size_t nrTriangles{ indices.size() / 3 };
+
+			std::vector<size_t> targets{};
+			for (int lod{ 1 }; lod < maxNrLODs; ++lod)
+			{
+				targets.push_back(nrTriangles >> lod);
+			}
+
+			//Error limit relative to the size of the mesh
+			Vector3 min{ vertices.empty() ? Vector3{} : vertices[0].position };
+			Vector3 max{ min };
+			for (const Vertex& vertex : vertices)
+			{
+				for (int axis{}; axis < 3; ++axis)
+				{
+					min[axis] = std::min(min[axis], vertex.position[axis]);
+					max[axis] = std::max(max[axis], vertex.position[axis]);
+				}
+			}
+
+			const float maxDistance{ 0.5f * (max - min).Magnitude() * maxRelativeError };
+
+			std::vector<std::vector<uint32_t>> levels{ Simplifier{ vertices, indices }.Simplify(targets, maxDistance * maxDistance) };
+			levels.insert(levels.begin(), indices);
+
+			//Coarsest level every vertex is used in, the vertices of the coarse levels go first
+			std::vector<int> coarsestLevel(vertices.size());
+			for (int level{ 1 }; level < static_cast<int>(levels.size()); ++level)
+			{
+				for (uint32_t index : levels[level])
+				{
+					coarsestLevel[index] = level;
+				}
+			}
+
+			std::vector<uint32_t> order(vertices.size());
+			for (uint32_t index{}; index < order.size(); ++index)
+			{
+				order[index] = index;
+			}
+
+			std::stable_sort(order.begin(), order.end(), [&coarsestLevel](uint32_t a, uint32_t b) { return coarsestLevel[a] > coarsestLevel[b]; });
+
+			std::vector<uint32_t> newIndexOf(vertices.size());
+			std::vector<Vertex> orderedVertices(vertices.size());
+			for (uint32_t newIndex{}; newIndex < order.size(); ++newIndex)
+			{
+				newIndexOf[order[newIndex]] = newIndex;
+				orderedVertices[newIndex] = vertices[order[newIndex]];
+			}
+
+			vertices = std::move(orderedVertices);
+
+			//One index buffer, the levels one after the other
+			indices.clear();
+			meshData.lods.clear();
+
+			for (int level{}; level < static_cast<int>(levels.size()); ++level)
+			{
+				MeshLOD lod{};
+				lod.firstIndex = static_cast<uint32_t>(indices.size());
+				lod.nrIndices = static_cast<uint32_t>(levels[level].size());
+				lod.nrVertices = static_cast<uint32_t>(std::count_if(coarsestLevel.begin(), coarsestLevel.end(), [level](int coarsest) { return coarsest >= level; }));
+
+				for (uint32_t index : levels[level])
+				{
+					indices.push_back(newIndexOf[index]);
+				}
+
+				meshData.lods.push_back(lod);
+			}
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+struct MeshData;
+
+namespace dae
+{
+	namespace Utils
+	{
+		//Adds up to maxNrLODs - 1 simplified levels to meshData.lods, every level has about half the triangles of the one before.
+		//Quadric error metric edge collapses (Garland-Heckbert) that always collapse onto an existing vertex, so every level indexes the same vertices.
+		//The vertices are reordered so a level only uses the first lod.nrVertices of them, the software rasterizer only transforms those.
+		//Borders are locked, uv and normal seams can only collapse along the seam.
+		void GenerateLODs(MeshData& meshData, int maxNrLODs);
+	}
+}
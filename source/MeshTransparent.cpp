@@ -6,18 +6,23 @@
 #include "Texture.h"
 #include "EffectTransparent.h"
 #include "Utils.h"
+#include "TriangleSetup.h"
+#include "Heatmap.h"
+#include "FrameBuffer.h"
+#include <bit>
 
 //---------------------------
 // Constructor & Destructor
 //---------------------------
 
-MeshTransparent::MeshTransparent(ID3D11Device* pDevice, const std::string& filename, Texture* pDiffuseMap)
-	:Mesh(pDevice, filename)
+MeshTransparent::MeshTransparent(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat, Texture* pDiffuseMap)
+	:Mesh(pDevice, meshData, vertexFormat)
 {
 	PrintTypeName();
 
 	//Effect
-	m_pEffect = std::make_unique<EffectTransparent>(pDevice, L"Resources/Transparent.fx");
+	m_pEffect = std::make_unique<EffectTransparent>(pDevice, L"Resources/Transparent.fx", m_VertexFormat);
+	m_pEffect->SetPositionQuantization(m_PositionQuantization);
 	m_CullMode = CullMode::NoCulling;
 
 	SetDiffuseMap(pDiffuseMap);
@@ -26,76 +31,151 @@ MeshTransparent::MeshTransparent(ID3D11Device* pDevice, const std::string& filen
 //---------------------------
 // Member functions
 //---------------------------
-void MeshTransparent::SoftwareRender(int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels)
+void MeshTransparent::SoftwareRender(const dae::FrameBufferLayout& layout, int nrSamples, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels, dae::FrameArena& frameArena)
 {
+	const int width{ layout.width };
+	const int height{ layout.height };
 	EffectTransparent* pEffect{ static_cast<EffectTransparent*>(m_pEffect.get()) };
 
-	pEffect->VertexTransformationFunction(m_Vertices, m_VerticesOut, m_Indices);
+	const RasterizeFunction rasterizeFunction{ nrSamples > 1 ? SelectRasterizeFunction<4>() : SelectRasterizeFunction<1>() };
 
-	for (size_t index{}; index < m_Vertices.size(); ++index)
+	m_CullStatistics = {};
+	AllocateFrameBuffers(frameArena);
+
+	//The instances share the vertex buffers. The vertices of a batch of instances are transformed together, then its instances are rasterized one after the other
+	//Instances are sorted by level of detail, a level only transforms the vertices it uses
+	const dae::Matrix* pWorldMatrix{ m_InstanceWorldMatrices.data() };
+
+	for (size_t lod{}; lod < m_LODs.size(); ++lod)
 	{
-		//NDC space -> Raster space
-		m_VerticesOut[index].position.x = 0.5f * (m_VerticesOut[index].position.x + 1.f) * width;
-		m_VerticesOut[index].position.y = 0.5f * (1.f - m_VerticesOut[index].position.y) * height;
+		const MeshLOD& meshLOD{ m_LODs[lod] };
+		const uint32_t nrVertices{ meshLOD.nrVertices };
+		const uint32_t nrInstances{ m_LODStatistics.nrInstances[lod] };
+		const uint32_t batchSize{ GetBatchSize(meshLOD) };
+
+		for (uint32_t firstInstance{}; firstInstance < nrInstances; firstInstance += batchSize)
+		{
+			const uint32_t nrBatchInstances{ std::min(batchSize, nrInstances - firstInstance) };
+			const std::span<VertexOut> batchVertices{ m_BatchVerticesOut.first(static_cast<size_t>(nrBatchInstances) * nrVertices) };
+
+			for (uint32_t instance{}; instance < nrBatchInstances; ++instance)
+			{
+				const std::span<VertexOut> verticesOut{ batchVertices.subspan(static_cast<size_t>(instance) * nrVertices, nrVertices) };
+
+				pEffect->SetWorldMatrix(pWorldMatrix[instance]);
+				if (m_VertexFormat == VertexFormat::Compressed)
+				{
+					pEffect->VertexTransformationFunction(m_CompressedVertices, verticesOut, nrVertices);
+				}
+				else
+				{
+					pEffect->VertexTransformationFunction(m_Vertices, verticesOut, nrVertices);
+				}
+			}
+
+			TransformToRasterSpace(width, height, batchVertices);
+
+			for (uint32_t instance{}; instance < nrBatchInstances; ++instance)
+			{
+				m_VerticesOut = batchVertices.subspan(static_cast<size_t>(instance) * nrVertices, nrVertices);
+				CullTriangles(width, height, meshLOD);
+
+				//Specialized raster loop, picked once per frame (rasterizeFunction) so the modes are not checked per pixel
+				(this->*rasterizeFunction)(layout, pBackBuffer, pBackBufferPixels, pDepthBufferPixels);
+			}
+
+			pWorldMatrix += nrBatchInstances;
+		}
 	}
+}
 
-	for (size_t index{}; index < m_MaxCount; index += m_Increment)
-	{
-		//Frustrum culling
-		if (m_VerticesOut[m_Indices[index]].position.z < 0.f || m_VerticesOut[m_Indices[index]].position.z > 1.f ||
-			m_VerticesOut[m_Indices[index + 1]].position.z < 0.f || m_VerticesOut[m_Indices[index + 1]].position.z > 1.f ||
-			m_VerticesOut[m_Indices[index + 2]].position.z < 0.f || m_VerticesOut[m_Indices[index + 2]].position.z > 1.f) continue;
+template<int nrSamples, bool showBoundingBox, bool showDepth>
+void MeshTransparent::RasterizeTriangles(const dae::FrameBufferLayout& layout, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels)
+{
+	const EffectTransparent* pEffect{ static_cast<EffectTransparent*>(m_pEffect.get()) };
+	const int width{ layout.width };
+	const int height{ layout.height };
+	const int planeSize{ layout.planeSize };
 
-		//Discard triangles where two indices are the same
-		if (m_Indices[index] == m_Indices[index + 1] || m_Indices[index] == m_Indices[index + 2] || m_Indices[index + 1] == m_Indices[index + 2]) continue;
+	//Counters of the heatmap, only while one is shown
+	dae::Heatmap* pHeatmap{ m_pHeatmap };
 
-		//Vertices
-		const dae::Vector2 v0{ m_VerticesOut[m_Indices[index]].position.GetXY() };
-		const dae::Vector2 v1{ m_VerticesOut[m_Indices[index + 1]].position.GetXY() };
-		const dae::Vector2 v2{ m_VerticesOut[m_Indices[index + 2]].position.GetXY() };
+	for (const TriangleIndices& triangle : m_VisibleTriangles)
+	{
+		const uint32_t i0{ triangle.i0 };
+		const uint32_t i1{ triangle.i1 };
+		const uint32_t i2{ triangle.i2 };
 
-		//Get values for boundingbox
-		dae::Vector2 min{ std::min(v0.x, v1.x),std::min(v0.y, v1.y) };
-		min.x = std::min(min.x, v2.x);
-		min.y = std::min(min.y, v2.y);
+		const dae::Vector4& p0{ m_VerticesOut[i0].position };
+		const dae::Vector4& p1{ m_VerticesOut[i1].position };
+		const dae::Vector4& p2{ m_VerticesOut[i2].position };
 
-		dae::Vector2 max{ std::max(v0.x, v1.x),std::max(v0.y, v1.y) };
-		max.x = std::max(max.x, v2.x);
-		max.y = std::max(max.y, v2.y);
+		//Triangle setup
+		dae::TriangleSetup setup{};
+		if (!setup.Setup(p0, p1, p2, width, height)) continue;
 
+		const int uvPlane{ setup.AddAttribute(m_VerticesOut[i0].uv, m_VerticesOut[i1].uv, m_VerticesOut[i2].uv) };
+		const dae::TriangleSamples<nrSamples> samples{ setup };
 
 		//RENDER LOGIC
-		for (int px{ std::max(0,static_cast<int>(min.x)) }; px <= std::min(width - 1, static_cast<int>(max.x)); ++px)
+		for (int py{ setup.min.y }; py <= setup.max.y; ++py)
 		{
-			for (int py{ std::max(0,static_cast<int>(min.y)) }; py <= std::min(height - 1, static_cast<int>(max.y)); ++py)
+			dae::TriangleSpan span{};
+			span.Begin(setup, static_cast<float>(setup.min.x), static_cast<float>(py));
+
+			//The cycles of the row go to a tile whenever the row enters the next one
+			uint64_t tileStartCycles{ pHeatmap ? dae::Heatmap::GetCycles() : 0 };
+
+			for (int px{ setup.min.x }; px <= setup.max.x; ++px, span.Step(setup))
 			{
-				if (m_ShowBoundingbox)
+				//Color and depth can be tiled, the pixel data of the mesh is linear
+				const int pixelIndex{ px + (py * width) };
+				const int bufferIndex{ layout.GetIndex(px, py) };
+
+				if (pHeatmap && px % dae::Heatmap::tileSize == 0 && px != setup.min.x)
+				{
+					const uint64_t cycles{ dae::Heatmap::GetCycles() };
+					pHeatmap->AddTileCycles(px - 1, py, cycles - tileStartCycles);
+					tileStartCycles = cycles;
+				}
+
+				if constexpr (showBoundingBox)
 				{
-					pBackBufferPixels[static_cast<int>(px) + (static_cast<int>(py) * width)] = SDL_MapRGB(pBackBuffer->format,
-						static_cast<uint8_t>(255),
-						static_cast<uint8_t>(255),
-						static_cast<uint8_t>(255));
+					for (int sample{}; sample < nrSamples; ++sample)
+					{
+						pBackBufferPixels[sample * planeSize + bufferIndex] = SDL_MapRGB(pBackBuffer->format,
+							static_cast<uint8_t>(255),
+							static_cast<uint8_t>(255),
+							static_cast<uint8_t>(255));
+					}
 					continue;
 				}
 
-				//Rasterization
-				dae::Vector3 vertexRatio{};
-				const bool shouldSwap{ !m_IsTriangleList && index & 0x01 };
+				//Rasterization, coverage and depth are tested per sample (without writing depth)
+				const uint32_t coverage{ samples.GetCoverage(span) };
+				if (coverage == 0) continue;
 
-				if (!dae::Utils::IsPixelInTriangle(dae::Vector2{ static_cast<float>(px),static_cast<float>(py) }, v0, v1, v2, vertexRatio, shouldSwap)) continue;
+				const uint32_t visibleSamples{ samples.template DepthTest<false>(span, coverage, pDepthBufferPixels, bufferIndex, planeSize) };
 
-				//Attribute Interpolation
-				const float currentDepth{ 1.f / ((vertexRatio.x / m_VerticesOut[m_Indices[index]].position.z) + (vertexRatio.y / m_VerticesOut[m_Indices[index + 1]].position.z) + (vertexRatio.z / m_VerticesOut[m_Indices[index + 2]].position.z)) };
+				if (pHeatmap)
+				{
+					pHeatmap->AddDepthFails(pixelIndex, static_cast<uint32_t>(std::popcount(coverage & ~visibleSamples)));
+					if (visibleSamples != 0) pHeatmap->AddFragment(pixelIndex);
+				}
 
-				if (currentDepth < pDepthBufferPixels[px + (py * width)])
+				if (visibleSamples != 0)
 				{
 					//Not visible in depth view
-					if (m_ShowDepth)
+					if constexpr (showDepth)
 					{
 						continue;
 					}
 
-					const float wInterpolated{ 1.f / ((vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w) + (vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w) + (vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w)) };
+					const uint64_t shadingStartCycles{ pHeatmap ? dae::Heatmap::GetCycles() : 0 };
+
+					//Attribute Interpolation, sampled once per pixel at its corner
+					const float currentDepth{ span.GetDepth() };
+					const float wInterpolated{ span.GetW() };
 
 					VertexOut pixel
 					{
@@ -106,20 +186,46 @@ void MeshTransparent::SoftwareRender(int width, int height, SDL_Surface* pBackBu
 							currentDepth,
 							wInterpolated
 						},
-						dae::Vector2 //uv
-						{
-							(m_Vertices[m_Indices[index]].uv * vertexRatio.x * m_VerticesOut[m_Indices[index]].position.w + m_Vertices[m_Indices[index + 1]].uv * vertexRatio.y * m_VerticesOut[m_Indices[index + 1]].position.w + m_Vertices[m_Indices[index + 2]].uv * vertexRatio.z * m_VerticesOut[m_Indices[index + 2]].position.w) * wInterpolated
-						}
+						span.GetVector2(uvPlane, wInterpolated) //uv
 					};
 
-					pEffect->PixelShading(pixel, width, height, pBackBuffer, pBackBufferPixels);
+					const dae::Vector4 color{ pEffect->PixelShading(pixel) };
+
+					//Blended with every sample, they can hold different colors
+					for (int sample{}; sample < nrSamples; ++sample)
+					{
+						if (!(visibleSamples >> sample & 0x01)) continue;
+
+						uint32_t& destination{ pBackBufferPixels[sample * planeSize + bufferIndex] };
+						destination = pEffect->Blend(color, destination, pBackBuffer->format);
+					}
+
+					if (pHeatmap) pHeatmap->AddShadingCycles(pixelIndex, dae::Heatmap::GetCycles() - shadingStartCycles);
 				}
 			}
+
+			if (pHeatmap) pHeatmap->AddTileCycles(setup.max.x, py, dae::Heatmap::GetCycles() - tileStartCycles);
 		}
 	}
 }
 	
 
+template<int nrSamples>
+MeshTransparent::RasterizeFunction MeshTransparent::SelectRasterizeFunction() const
+{
+	if (m_ShowBoundingbox)
+	{
+		return &MeshTransparent::RasterizeTriangles<nrSamples, true, false>;
+	}
+
+	if (m_ShowDepth)
+	{
+		return &MeshTransparent::RasterizeTriangles<nrSamples, false, true>;
+	}
+
+	return &MeshTransparent::RasterizeTriangles<nrSamples, false, false>;
+}
+
 void MeshTransparent::PrintTypeName()
 {
 	std::cout << "----------------------------\n";
@@ -13,7 +13,7 @@ class Texture;
 class MeshTransparent final : public Mesh
 {
 public:
-	MeshTransparent(ID3D11Device* pDevice, const std::string& filename, Texture* pDiffuseMap);
+	MeshTransparent(ID3D11Device* pDevice, const MeshData& meshData, VertexFormat vertexFormat, Texture* pDiffuseMap);
 	~MeshTransparent() = default;
 
 	// -------------------------
@@ -27,8 +27,20 @@ public:
 	//-------------------------------------------------
 	// Member functions						
 	//-------------------------------------------------
-	virtual void SoftwareRender(int width, int height, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels) override;
+	virtual void SoftwareRender(const dae::FrameBufferLayout& layout, int nrSamples, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels, dae::FrameArena& frameArena) override;
 	virtual void PrintTypeName() override;
 
 	void SetDiffuseMap(Texture* pDiffuseMap);
+
+private:
+	//-------------------------------------------------
+	// Private member functions								
+	//-------------------------------------------------
+	using RasterizeFunction = void (MeshTransparent::*)(const dae::FrameBufferLayout&, SDL_Surface*, uint32_t*, float*);
+
+	template<int nrSamples, bool showBoundingBox, bool showDepth>
+	void RasterizeTriangles(const dae::FrameBufferLayout& layout, SDL_Surface* pBackBuffer, uint32_t* pBackBufferPixels, float* pDepthBufferPixels);
+
+	template<int nrSamples>
+	RasterizeFunction SelectRasterizeFunction() const;
 };
\ No newline at end of file
@@ -0,0 +1,488 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "ObjParser.h"
+#include <charconv>
+#include <cstring>
+#include "Mesh.h"
+#include "Utils.h"
+#include "Parallel.h"
+
+namespace
+{
+	//Read only view of a whole file
+	class MappedFile final
+	{
+	public:
+		explicit MappedFile(const std::string& filename)
+		{
+			m_File = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_File == INVALID_HANDLE_VALUE) return;
+
+			LARGE_INTEGER size{};
+			if (!GetFileSizeEx(m_File, &size)) return;
+
+			m_Size = static_cast<size_t>(size.QuadPart);
+			m_IsValid = true;
+
+			//Empty files can not be mapped
+			if (m_Size == 0) return;
+
+			m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!m_Mapping)
+			{
+				m_IsValid = false;
+				return;
+			}
+
+			m_pData = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+			m_IsValid = m_pData != nullptr;
+		}
+
+		~MappedFile()
+		{
+			if (m_pData)
+			{
+				UnmapViewOfFile(m_pData);
+			}
+
+			if (m_Mapping)
+			{
+				CloseHandle(m_Mapping);
+			}
+
+			if (m_File != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_File);
+			}
+		}
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile(MappedFile&& other) noexcept = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		MappedFile& operator=(MappedFile&& other) noexcept = delete;
+
+		bool IsValid() const { return m_IsValid; }
+		const char* GetData() const { return m_pData; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		HANDLE m_File{ INVALID_HANDLE_VALUE };
+		HANDLE m_Mapping{ nullptr };
+		const char* m_pData{ nullptr };
+		size_t m_Size{};
+		bool m_IsValid{ false };
+	};
+
+	//Part of the file that starts and ends on a line boundary
+	struct Chunk
+	{
+		const char* pBegin{};
+		const char* pEnd{};
+
+		//Counted in the first pass
+		size_t nrPositions{};
+		size_t nrUVs{};
+		size_t nrNormals{};
+		size_t nrCorners{};
+		size_t nrTriangles{};
+
+		//Where the chunk writes its output, prefix sums of the counts
+		size_t firstPosition{};
+		size_t firstUV{};
+		size_t firstNormal{};
+		size_t firstCorner{};
+		size_t firstTriangle{};
+	};
+
+	//Zero based indices of one face corner, -1 when the attribute is missing
+	struct Corner
+	{
+		int64_t position{ -1 };
+		int64_t uv{ -1 };
+		int64_t normal{ -1 };
+	};
+
+	enum class Command { Position, UV, Normal, Face, Other };
+
+	constexpr size_t minChunkSize{ 256 * 1024 };
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	const char* SkipSpaces(const char* p, const char* pEnd)
+	{
+		while (p < pEnd && IsSpace(*p)) ++p;
+		return p;
+	}
+
+	const char* SkipToken(const char* p, const char* pEnd)
+	{
+		while (p < pEnd && !IsSpace(*p) && *p != '\n') ++p;
+		return p;
+	}
+
+	const char* FindLineEnd(const char* p, const char* pEnd)
+	{
+		const void* pNewLine{ std::memchr(p, '\n', pEnd - p) };
+		return pNewLine ? static_cast<const char*>(pNewLine) : pEnd;
+	}
+
+	//Returns the command of the line, p is moved past it
+	Command ReadCommand(const char*& p, const char* pLineEnd)
+	{
+		p = SkipSpaces(p, pLineEnd);
+
+		const size_t length{ static_cast<size_t>(SkipToken(p, pLineEnd) - p) };
+		const char* pCommand{ p };
+		p += length;
+
+		if (length == 1 && pCommand[0] == 'v') return Command::Position;
+		if (length == 1 && pCommand[0] == 'f') return Command::Face;
+		if (length == 2 && pCommand[0] == 'v' && pCommand[1] == 't') return Command::UV;
+		if (length == 2 && pCommand[0] == 'v' && pCommand[1] == 'n') return Command::Normal;
+
+		return Command::Other;
+	}
+
+	float ReadFloat(const char*& p, const char* pLineEnd)
+	{
+		p = SkipSpaces(p, pLineEnd);
+		if (p < pLineEnd && *p == '+') ++p;
+
+		float value{};
+		const std::from_chars_result result{ std::from_chars(p, pLineEnd, value) };
+
+		//Skip whatever could not be parsed, the value stays 0
+		p = result.ec == std::errc{} ? result.ptr : SkipToken(p, pLineEnd);
+		return value;
+	}
+
+	//Converts a one based (or negative, relative to the elements read so far) OBJ index to a zero based index
+	int64_t ReadIndex(const char*& p, const char* pLineEnd, size_t nrElementsSoFar)
+	{
+		int64_t value{};
+		const std::from_chars_result result{ std::from_chars(p, pLineEnd, value) };
+		if (result.ec != std::errc{}) return -1;
+
+		p = result.ptr;
+
+		if (value > 0) return value - 1;
+		if (value < 0) return static_cast<int64_t>(nrElementsSoFar) + value;
+		return -1;
+	}
+
+	size_t CountCorners(const char* p, const char* pLineEnd)
+	{
+		size_t nrCorners{};
+
+		for (p = SkipSpaces(p, pLineEnd); p < pLineEnd; p = SkipSpaces(p, pLineEnd))
+		{
+			p = SkipToken(p, pLineEnd);
+			++nrCorners;
+		}
+
+		return nrCorners;
+	}
+
+	//First pass: how much every chunk will output, nothing is stored
+	void CountChunk(Chunk& chunk)
+	{
+		for (const char* p{ chunk.pBegin }; p < chunk.pEnd;)
+		{
+			const char* pLineEnd{ FindLineEnd(p, chunk.pEnd) };
+
+			switch (ReadCommand(p, pLineEnd))
+			{
+			case Command::Position:
+				++chunk.nrPositions;
+				break;
+			case Command::UV:
+				++chunk.nrUVs;
+				break;
+			case Command::Normal:
+				++chunk.nrNormals;
+				break;
+			case Command::Face:
+			{
+				//Faces with less than 3 corners are skipped
+				const size_t nrCorners{ CountCorners(p, pLineEnd) };
+				if (nrCorners >= 3)
+				{
+					chunk.nrCorners += nrCorners;
+					chunk.nrTriangles += nrCorners - 2;
+				}
+				break;
+			}
+			default:
+				break;
+			}
+
+			p = pLineEnd + 1;
+		}
+	}
+
+	//Second pass: attributes, corners and indices are written straight to their place in the output
+	void ParseChunk(const Chunk& chunk, std::vector<dae::Vector3>& positions, std::vector<dae::Vector2>& UVs, std::vector<dae::Vector3>& normals,
+		std::vector<Corner>& corners, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+	{
+		size_t positionIndex{ chunk.firstPosition };
+		size_t uvIndex{ chunk.firstUV };
+		size_t normalIndex{ chunk.firstNormal };
+		size_t cornerIndex{ chunk.firstCorner };
+		size_t index{ chunk.firstTriangle * 3 };
+
+		for (const char* p{ chunk.pBegin }; p < chunk.pEnd;)
+		{
+			const char* pLineEnd{ FindLineEnd(p, chunk.pEnd) };
+
+			switch (ReadCommand(p, pLineEnd))
+			{
+			case Command::Position:
+			{
+				const float x{ ReadFloat(p, pLineEnd) };
+				const float y{ ReadFloat(p, pLineEnd) };
+				const float z{ ReadFloat(p, pLineEnd) };
+				positions[positionIndex++] = { x, y, z };
+				break;
+			}
+			case Command::UV:
+			{
+				const float u{ ReadFloat(p, pLineEnd) };
+				const float v{ ReadFloat(p, pLineEnd) };
+				UVs[uvIndex++] = { u, 1 - v };
+				break;
+			}
+			case Command::Normal:
+			{
+				const float x{ ReadFloat(p, pLineEnd) };
+				const float y{ ReadFloat(p, pLineEnd) };
+				const float z{ ReadFloat(p, pLineEnd) };
+				normals[normalIndex++] = { x, y, z };
+				break;
+			}
+			case Command::Face:
+			{
+				const size_t nrCorners{ CountCorners(p, pLineEnd) };
+				if (nrCorners < 3) break;
+
+				const size_t firstCorner{ cornerIndex };
+
+				//position, position/uv, position//normal or position/uv/normal
+				for (p = SkipSpaces(p, pLineEnd); p < pLineEnd; p = SkipSpaces(p, pLineEnd))
+				{
+					Corner& corner{ corners[cornerIndex++] };
+					corner.position = ReadIndex(p, pLineEnd, positionIndex);
+
+					if (p < pLineEnd && *p == '/')
+					{
+						++p;
+
+						if (p < pLineEnd && *p != '/')
+						{
+							corner.uv = ReadIndex(p, pLineEnd, uvIndex);
+						}
+
+						if (p < pLineEnd && *p == '/')
+						{
+							++p;
+							corner.normal = ReadIndex(p, pLineEnd, normalIndex);
+						}
+					}
+
+					p = SkipToken(p, pLineEnd);
+				}
+
+				//Fan triangulation, every corner is its own vertex like in ParseOBJ
+				for (size_t corner{ 1 }; corner + 1 < nrCorners; ++corner)
+				{
+					const uint32_t i0{ static_cast<uint32_t>(firstCorner) };
+					const uint32_t i1{ static_cast<uint32_t>(firstCorner + corner) };
+					const uint32_t i2{ static_cast<uint32_t>(firstCorner + corner + 1) };
+
+					indices[index++] = i0;
+					indices[index++] = flipAxisAndWinding ? i2 : i1;
+					indices[index++] = flipAxisAndWinding ? i1 : i2;
+				}
+				break;
+			}
+			default:
+				break;
+			}
+
+			p = pLineEnd + 1;
+		}
+	}
+
+	template<typename T>
+	T GetAttribute(const std::vector<T>& attributes, int64_t index)
+	{
+		return index >= 0 && static_cast<size_t>(index) < attributes.size() ? attributes[static_cast<size_t>(index)] : T{};
+	}
+}
+
+namespace dae
+{
+	namespace Utils
+	{
+		bool ParseOBJFast(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+		{
+			const MappedFile file{ filename };
+			if (!file.IsValid())
+				return false;
+
+			const char* pData{ file.GetData() };
+			const size_t size{ file.GetSize() };
+
+			//Split in line aligned chunks, small files are not worth the threads
+			const size_t nrChunks{ std::clamp<size_t>(size / minChunkSize, 1, static_cast<size_t>(GetNrWorkers())) };
+			std::vector<Chunk> chunks(nrChunks);
+
+			const char* pBegin{ pData };
+			for (size_t chunkIndex{}; chunkIndex < nrChunks; ++chunkIndex)
+			{
+				const char* pEnd{ pData + size };
+
+				if (chunkIndex + 1 < nrChunks)
+				{
+					pEnd = std::max(pBegin, pData + size * (chunkIndex + 1) / nrChunks);
+					pEnd = std::min(FindLineEnd(pEnd, pData + size) + 1, pData + size);
+				}
+
+				chunks[chunkIndex].pBegin = pBegin;
+				chunks[chunkIndex].pEnd = pEnd;
+				pBegin = pEnd;
+			}
+
+			ParallelFor(static_cast<int>(nrChunks), [&chunks](int chunkIndex) { CountChunk(chunks[chunkIndex]); });
+
+			//Prefix sums, so every chunk knows where to write
+			Chunk totals{};
+			for (Chunk& chunk : chunks)
+			{
+				chunk.firstPosition = totals.nrPositions;
+				chunk.firstUV = totals.nrUVs;
+				chunk.firstNormal = totals.nrNormals;
+				chunk.firstCorner = totals.nrCorners;
+				chunk.firstTriangle = totals.nrTriangles;
+
+				totals.nrPositions += chunk.nrPositions;
+				totals.nrUVs += chunk.nrUVs;
+				totals.nrNormals += chunk.nrNormals;
+				totals.nrCorners += chunk.nrCorners;
+				totals.nrTriangles += chunk.nrTriangles;
+			}
+
+			//Everything is sized once, the passes only write
+			std::vector<Vector3> positions(totals.nrPositions);
+			std::vector<Vector2> UVs(totals.nrUVs);
+			std::vector<Vector3> normals(totals.nrNormals);
+			std::vector<Corner> corners(totals.nrCorners);
+
+			vertices.clear();
+			vertices.resize(totals.nrCorners);
+
+			indices.clear();
+			indices.resize(totals.nrTriangles * 3);
+
+			ParallelFor(static_cast<int>(nrChunks), [&](int chunkIndex)
+				{
+					ParseChunk(chunks[chunkIndex], positions, UVs, normals, corners, indices, flipAxisAndWinding);
+				});
+
+			//Faces can use attributes from other chunks, so the vertices are gathered after all chunks are parsed
+			const int nrTasks{ static_cast<int>(nrChunks) };
+			ParallelFor(nrTasks, [&](int task)
+				{
+					const size_t first{ totals.nrCorners * task / nrTasks };
+					const size_t last{ totals.nrCorners * (task + 1) / nrTasks };
+
+					for (size_t index{ first }; index < last; ++index)
+					{
+						Vertex& vertex{ vertices[index] };
+						vertex.position = GetAttribute(positions, corners[index].position);
+						vertex.uv = GetAttribute(UVs, corners[index].uv);
+						vertex.normal = GetAttribute(normals, corners[index].normal);
+					}
+				});
+
+			FinalizeOBJ(vertices, indices, flipAxisAndWinding);
+
+			return true;
+		}
+
+		bool BenchmarkOBJ(const std::string& filename, int nrRuns)
+		{
+			std::vector<Vertex> referenceVertices{};
+			std::vector<uint32_t> referenceIndices{};
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+
+			//Best of the runs, the first run also pays for a cold file cache. Every run is one frame of the timer
+			const auto measure = [nrRuns](const auto& parse) -> double
+			{
+				Timer timer{ Timer::Clock::Steady };
+
+				for (int run{}; run < nrRuns; ++run)
+				{
+					timer.Reset();
+					if (!parse()) return 0.0;
+
+					timer.Update();
+				}
+
+				return timer.GetFrameTimePercentile(0.f) / 1000.0;
+			};
+
+			const double referenceSeconds{ measure([&]() { return ParseOBJ(filename, referenceVertices, referenceIndices); }) };
+			const double seconds{ measure([&]() { return ParseOBJFast(filename, vertices, indices); }) };
+
+			std::cout << "----------------------------\n";
+			std::cout << "OBJ BENCHMARK: " << filename << '\n';
+
+			if (referenceSeconds == 0.0 || seconds == 0.0)
+			{
+				std::cout << "Failed to load the file\n";
+				std::cout << "----------------------------\n";
+				return false;
+			}
+
+			//Attributes are parsed by different float parsers, allow for a difference in the last bit.
+			//Degenerate uv triangles get a tangent from GenerateTangents, but vertices without a normal (an OBJ without vn) still give NaN tangents in both parsers
+			const auto isClose = [](float a, float b)
+			{
+				return (std::isnan(a) && std::isnan(b)) || std::abs(a - b) <= 1e-5f * std::max(1.f, std::abs(a));
+			};
+
+			bool isEqual{ referenceVertices.size() == vertices.size() && referenceIndices == indices };
+
+			for (size_t index{}; isEqual && index < vertices.size(); ++index)
+			{
+				const Vertex& a{ referenceVertices[index] };
+				const Vertex& b{ vertices[index] };
+
+				for (int component{}; component < 3; ++component)
+				{
+					isEqual &= isClose(a.position[component], b.position[component]);
+					isEqual &= isClose(a.normal[component], b.normal[component]);
+					isEqual &= isClose(a.tangent[component], b.tangent[component]);
+				}
+
+				isEqual &= isClose(a.uv.x, b.uv.x) && isClose(a.uv.y, b.uv.y);
+			}
+
+			const double megabytes{ MappedFile{ filename }.GetSize() / (1024.0 * 1024.0) };
+
+			std::cout << "Size: " << megabytes << " MB, " << vertices.size() << " vertices, " << indices.size() / 3 << " triangles\n";
+			std::cout << "ParseOBJ: " << megabytes / referenceSeconds << " MB/s\n";
+			std::cout << "ParseOBJFast: " << megabytes / seconds << " MB/s (" << referenceSeconds / seconds << "x, " << GetNrWorkers() << " threads)\n";
+			std::cout << "Parity: " << (isEqual ? "OK" : "MISMATCH") << '\n';
+			std::cout << "----------------------------\n";
+
+			return isEqual;
+		}
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+struct Vertex;
+
+namespace dae
+{
+	namespace Utils
+	{
+		//Memory mapped OBJ parser, the file is split in line aligned chunks that are parsed on all cores.
+		//Output matches ParseOBJ for triangles. Quads and n-gons are triangulated as a fan, negative (relative) indices are supported.
+		bool ParseOBJFast(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true);
+
+		//Parses the file with both parsers, checks that the output is the same and prints the throughput of both in MB/s
+		bool BenchmarkOBJ(const std::string& filename, int nrRuns = 5);
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace dae
+{
+	//Number of threads worth splitting data parallel work over, at least one
+	inline int GetNrWorkers()
+	{
+		return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+
+	//Calls function(task) for every task in [0, nrTasks), the calling thread runs task 0.
+	//Returns when every task is done, the tasks should not share anything they write to.
+	template<typename Function>
+	void ParallelFor(int nrTasks, const Function& function)
+	{
+		if (nrTasks <= 0) return;
+
+		std::vector<std::future<void>> futures{};
+		futures.reserve(static_cast<size_t>(nrTasks) - 1);
+
+		for (int task{ 1 }; task < nrTasks; ++task)
+		{
+			futures.push_back(std::async(std::launch::async, [&function, task]() { function(task); }));
+		}
+
+		function(0);
+
+		for (std::future<void>& future : futures)
+		{
+			future.get();
+		}
+	}
+}
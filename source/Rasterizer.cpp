@@ -20,7 +20,7 @@ Rasterizer::Rasterizer(ID3D11Device* pDevice)
 	rasterizerDesc.DepthBiasClamp = 0.f;
 	rasterizerDesc.DepthClipEnable = true;
 	rasterizerDesc.ScissorEnable = false;
-	rasterizerDesc.MultisampleEnable = false;
+	rasterizerDesc.MultisampleEnable = true; //Only used by multisampled render targets
 	rasterizerDesc.AntialiasedLineEnable = false;
 
 	//Back face culling
@@ -7,6 +7,16 @@
 #include "Rasterizer.h"
 #include "Camera.h"
 #include "Utils.h"
+#include "Scene.h"
+#include "ResolutionController.h"
+#include "ShadingRate.h"
+#include "Hud.h"
+#include "Heatmap.h"
+#include "FrameArena.h"
+#include "AllocationCounter.h"
+#include "Parallel.h"
+#include <chrono>
+#include <emmintrin.h>
 
 namespace dae {
 
@@ -15,13 +25,19 @@ namespace dae {
 	{
 		//Initialize
 		SDL_GetWindowSize(pWindow, &m_Width, &m_Height);
+
+		//Starts at the window size, the buffers are big enough for it
+		m_RenderWidth = m_Width;
+		m_RenderHeight = m_Height;
+		m_pResolutionController = std::make_unique<ResolutionController>(m_Width, m_Height, m_FrameBudgetMilliseconds);
+		m_pShadingRateImage = std::make_unique<ShadingRateImage>();
+		m_pHud = std::make_unique<Hud>();
+		m_pHeatmap = std::make_unique<Heatmap>();
+		m_pFrameArena = std::make_unique<FrameArena>(m_FrameArenaCapacity);
 		
 		//Create Buffers (Software)
 		m_pFrontBuffer = SDL_GetWindowSurface(pWindow);
-		m_pBackBuffer = SDL_CreateRGBSurface(0, m_Width, m_Height, 32, 0, 0, 0, 0);
-		m_pBackBufferPixels = (uint32_t*)m_pBackBuffer->pixels;
-
-		m_pDepthBufferPixels = new float[m_Width * m_Height];
+		CreateBackBuffer();
 
 		//Initialize DirectX pipeline
 		const HRESULT result = InitializeDirectX();
@@ -40,32 +56,27 @@ namespace dae {
 		m_pCamera = std::make_unique<Camera>();
 		m_pCamera->Initialize(45.f, { 0.f,0.f,-50.f }, m_Width / static_cast<float>(m_Height));
 
-		//Init maps
-		m_pDiffuseMap = std::make_unique<Texture>(m_pDevice, "Resources/vehicle_diffuse.png");
-		m_pNormalMap = std::make_unique<Texture>(m_pDevice, "Resources/vehicle_normal.png");
-		m_pSpecularMap = std::make_unique<Texture>(m_pDevice, "Resources/vehicle_specular.png");
-		m_pGlossinessMap = std::make_unique<Texture>(m_pDevice, "Resources/vehicle_gloss.png");
-		m_pFireDiffuseMap = std::make_unique<Texture>(m_pDevice, "Resources/fireFX_diffuse.png");
-
 		//Init states
 		m_pSampler = std::make_unique<Sampler>(m_pDevice);
 		m_pRasterizer = std::make_unique<Rasterizer>(m_pDevice);
 
-		//Initialize Meshes
+		//Start loading the assets, the meshes are created in Update once everything they need is resident
+		m_pAssetManager = std::make_unique<AssetManager>(m_pDevice);
 
-		//Opaque
-		m_pVehicleMesh = std::make_unique<MeshOpaque>(m_pDevice, "Resources/vehicle.obj", m_pDiffuseMap.get(), m_pNormalMap.get(), m_pSpecularMap.get(), m_pGlossinessMap.get());
+		m_DiffuseMap = m_pAssetManager->LoadTexture("Resources/vehicle_diffuse.png");
+		m_NormalMap = m_pAssetManager->LoadTexture("Resources/vehicle_normal.png");
+		m_SpecularMap = m_pAssetManager->LoadTexture("Resources/vehicle_specular.png");
+		m_GlossinessMap = m_pAssetManager->LoadTexture("Resources/vehicle_gloss.png");
+		m_FireDiffuseMap = m_pAssetManager->LoadTexture("Resources/fireFX_diffuse.png");
 
-		m_pVehicleMesh->SetMatrices(m_pCamera.get());
-		m_pVehicleMesh->SetSamplerState(m_pSampler->GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT));
-		m_pVehicleMesh->SetRasterizerState(m_pRasterizer->GetRasterizerState(D3D11_CULL_BACK));
+		m_VehicleMeshData = m_pAssetManager->LoadMesh("Resources/vehicle.obj");
+		m_FireMeshData = m_pAssetManager->LoadMesh("Resources/fireFX.obj");
 
-		//Transparent
-		m_pFireMesh = std::make_unique<MeshTransparent>(m_pDevice, "Resources/fireFX.obj", m_pFireDiffuseMap.get());
+		m_OpaqueEffect = m_pAssetManager->LoadEffect(L"Resources/Opaque.fx");
+		m_TransparentEffect = m_pAssetManager->LoadEffect(L"Resources/Transparent.fx");
 
-		m_pFireMesh->SetMatrices(m_pCamera.get());
-		m_pFireMesh->SetSamplerState(m_pSampler->GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT));
-		m_pFireMesh->SetRasterizerState(m_pRasterizer->GetRasterizerState(D3D11_CULL_NONE));
+		//Scene
+		m_pScene = std::make_unique<Scene>();
 
 		SetBackColor();
 		PrintStartInfo();
@@ -75,25 +86,10 @@ namespace dae {
 
 	Renderer::~Renderer()
 	{
-		if (m_pRenderTargetView)
-		{
-			m_pRenderTargetView->Release();
-		}
+		//Workers still loading use the device
+		m_pAssetManager->WaitForAll();
 
-		if (m_pRenderTargetBuffer)
-		{
-			m_pRenderTargetBuffer->Release();
-		}
-
-		if (m_pDepthStencilView)
-		{
-			m_pDepthStencilView->Release();
-		}
-
-		if (m_pDepthStencilBuffer)
-		{
-			m_pDepthStencilBuffer->Release();
-		}
+		ReleaseRenderTargets();
 
 		if (m_pSwapChain)
 		{
@@ -112,57 +108,128 @@ namespace dae {
 			m_pDevice->Release();
 		}
 
-		delete[] m_pDepthBufferPixels;
+		//Recreated when the render resolution changes, the pixels belong to m_BackBuffer
+		SDL_FreeSurface(m_pBackBuffer);
 	}
 
 	void Renderer::Update(const Timer* pTimer)
 	{
+		//Resolution for this frame, from the render time of the previous frames. Skipped frames took no time to render
+		if (m_IsFrameRendered && m_pResolutionController->Update(m_RenderMilliseconds))
+		{
+			ApplyRenderResolution();
+		}
+
 		m_pCamera->Update(pTimer);
+		if (m_pCamera->hasChanged) Invalidate();
+
+		//The overlay is live, it keeps the frames coming
+		m_pHud->Update(pTimer);
+		if (m_ShowHud && m_IsSoftware) Invalidate();
+
+		//Nothing animates besides the rotation
+		if (m_ShouldRotate && (m_pVehicleMesh || m_pFireMesh)) Invalidate();
+
+		CreateLoadedMeshes();
 
-		if (m_ShouldRotate)
+		//Frustum culling per instance, shared by both rasterizers
+		const Frustum frustum{ Frustum::Create(m_pCamera->viewMatrix * m_pCamera->projectionMatrix) };
+
+		//One angle for both meshes, set on every frame so meshes that are (re)created later are in phase
+		if (m_ShouldRotate) m_RotationAngle = std::fmod(m_RotationAngle + pTimer->GetElapsed() * m_AngularSpeed, 2.f * static_cast<float>(M_PI));
+
+		if (m_pVehicleMesh)
 		{
-			const float angle{ pTimer->GetElapsed() * m_AngularSpeed };
+			m_pVehicleMesh->SetRotationY(m_RotationAngle);
 
-			m_pVehicleMesh->RotateY(angle);
-			m_pFireMesh->RotateY(angle);
+			m_pVehicleMesh->SetMatrices(m_pCamera.get());
+			m_IsVehicleVisible = m_pVehicleMesh->UpdateInstances(m_pScene->GetInstances(), frustum, *m_pCamera) > 0;
 		}
 
-		m_pVehicleMesh->SetMatrices(m_pCamera.get());
-		m_pFireMesh->SetMatrices(m_pCamera.get());
+		if (m_pFireMesh)
+		{
+			m_pFireMesh->SetRotationY(m_RotationAngle);
+
+			m_pFireMesh->SetMatrices(m_pCamera.get());
+			m_IsFireVisible = m_pFireMesh->UpdateInstances(m_pScene->GetInstances(), frustum, *m_pCamera) > 0;
+		}
 	}
 
 
-	void Renderer::Render() const
+	bool Renderer::Render()
 	{
+		//The last frame is still on screen
+		m_IsFrameRendered = m_NrFramesToRender > 0;
+		if (!m_IsFrameRendered) return false;
+
+		--m_NrFramesToRender;
+
+		const auto start{ std::chrono::steady_clock::now() };
+		const uint64_t nrAllocations{ GetNrHeapAllocations() };
+
 		if (m_IsSoftware)
 		{
 			//Lock BackBuffer
 			SDL_LockSurface(m_pBackBuffer);
-			
-			//Clear Depth Buffer
-			const int nrPixels{ m_Width * m_Height };
-			std::fill_n(m_pDepthBufferPixels, nrPixels, INFINITY);
 
-			SDL_FillRect(m_pBackBuffer, NULL, SDL_MapRGB(m_pBackBuffer->format, static_cast<Uint8>(m_BackColor.r * 255.f), static_cast<Uint8>(m_BackColor.g * 255.f), static_cast<Uint8>(m_BackColor.b * 255.f)));
+			//The transient buffers of the last frame are not used anymore
+			m_pFrameArena->Reset();
+
+			//With multisampling or tiles the meshes render into the color target, it is resolved into the back buffer afterwards
+			const int nrSamples{ m_UseMultisampling ? m_NrMultisamples : 1 };
+			const bool useColorTarget{ m_UseMultisampling || m_UseTiledLayout };
+
+			m_DepthTarget.Resize(m_RenderWidth, m_RenderHeight, nrSamples, m_UseTiledLayout);
+			if (useColorTarget) m_ColorTarget.Resize(m_RenderWidth, m_RenderHeight, nrSamples, m_UseTiledLayout);
+
+			FrameBuffer<uint32_t>& colorBuffer{ useColorTarget ? m_ColorTarget : m_BackBuffer };
+
+			//Clear Depth Buffer, the padding too
+			m_DepthTarget.Clear(INFINITY);
+
+			const Uint32 clearColor{ SDL_MapRGB(m_pBackBuffer->format, static_cast<Uint8>(m_BackColor.r * 255.f), static_cast<Uint8>(m_BackColor.g * 255.f), static_cast<Uint8>(m_BackColor.b * 255.f)) };
+			colorBuffer.Clear(clearColor);
+
+			if (m_HeatmapMode != HeatmapMode::Off)
+			{
+				m_pHeatmap->Begin(m_RenderWidth, m_RenderHeight);
+			}
 
 			//DrawCalls
-			m_pVehicleMesh->SoftwareRender(m_Width, m_Height, m_pBackBuffer, m_pBackBufferPixels, m_pDepthBufferPixels);
+			if (m_pVehicleMesh && m_IsVehicleVisible)
+			{
+				m_pVehicleMesh->SoftwareRender(m_DepthTarget.GetLayout(), nrSamples, m_pBackBuffer, colorBuffer.GetPixels(), m_DepthTarget.GetPixels(), *m_pFrameArena);
+			}
 
-			if (m_ShowFireMesh)
+			if (m_pFireMesh && m_ShowFireMesh && m_IsFireVisible)
 			{
-				m_pFireMesh->SoftwareRender(m_Width, m_Height, m_pBackBuffer, m_pBackBufferPixels, m_pDepthBufferPixels);
+				m_pFireMesh->SoftwareRender(m_DepthTarget.GetLayout(), nrSamples, m_pBackBuffer, colorBuffer.GetPixels(), m_DepthTarget.GetPixels(), *m_pFrameArena);
 			}
 
-			//Depth visualisation
+			if (useColorTarget)
+			{
+				ResolveColorTarget();
+			}
+
+			//The rates of the next frame, from the final colors of this one
+			if (m_ShadingRate == ShadingRate::Adaptive && !m_ShowDepth && !m_ShowBoundingBox)
+			{
+				m_pShadingRateImage->Update(m_BackBuffer.GetPixels(), m_BackBuffer.GetLayout().tileRowPitch, m_RenderWidth, m_RenderHeight, m_pBackBuffer->format);
+			}
+
+			//Depth visualisation, the first sample with multisampling
 			if (m_ShowDepth)
 			{
-				for (int px{ 0 }; px <= m_Width - 1; ++px)
+				const FrameBufferLayout& depthLayout{ m_DepthTarget.GetLayout() };
+				const FrameBufferLayout& backBufferLayout{ m_BackBuffer.GetLayout() };
+
+				for (int px{ 0 }; px <= m_RenderWidth - 1; ++px)
 				{
-					for (int py{ 0 }; py <= m_Height - 1; ++py)
+					for (int py{ 0 }; py <= m_RenderHeight - 1; ++py)
 					{
-						const float remappedDepth{ 255.f * dae::Remap(m_pDepthBufferPixels[static_cast<int>(px) + (static_cast<int>(py) * m_Width)],0.995f) };
+						const float remappedDepth{ 255.f * dae::Remap(m_DepthTarget.GetPixels()[depthLayout.GetIndex(px, py)],0.995f) };
 
-						m_pBackBufferPixels[static_cast<int>(px) + (static_cast<int>(py) * m_Width)] = SDL_MapRGB(m_pBackBuffer->format,
+						m_BackBuffer.GetPixels()[backBufferLayout.GetIndex(px, py)] = SDL_MapRGB(m_pBackBuffer->format,
 							static_cast<uint8_t>(remappedDepth),
 							static_cast<uint8_t>(remappedDepth),
 							static_cast<uint8_t>(remappedDepth));
@@ -170,37 +237,198 @@ namespace dae {
 				}
 			}
 
+			//Heatmap, in place of the image (after the shading rates, they are chosen from the real colors)
+			if (m_HeatmapMode != HeatmapMode::Off)
+			{
+				m_pHeatmap->Draw(m_HeatmapMode, m_BackBuffer.GetPixels(), m_BackBuffer.GetLayout().tileRowPitch, m_pBackBuffer->format);
+			}
+
 			//Update SDL Surface
 			SDL_UnlockSurface(m_pBackBuffer);
-			SDL_BlitSurface(m_pBackBuffer, 0, m_pFrontBuffer, 0);
+
+			//Stretched to the window when the render resolution is lower, a plain blit otherwise
+			SDL_BlitScaled(m_pBackBuffer, nullptr, m_pFrontBuffer, nullptr);
+
+			if (m_ShowHud)
+			{
+				DrawHud();
+			}
 
 			SDL_UpdateWindowSurface(m_pWindow);
 		}
 		else if(m_IsInitialized)
 		{
+			//0. Bind the multisampled targets when they are used
+			const bool useMultisampling{ m_UseMultisampling && m_pMultisampleDepthStencilView };
+			ID3D11RenderTargetView* pRenderTargetView{ useMultisampling ? m_pMultisampleRenderTargetView : m_pRenderTargetView };
+			ID3D11DepthStencilView* pDepthStencilView{ useMultisampling ? m_pMultisampleDepthStencilView : m_pDepthStencilView };
+
+			m_pDeviceContext->OMSetRenderTargets(1, &pRenderTargetView, pDepthStencilView);
+
 			//1. Clear RTV & DSV
-			m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, &m_BackColor.r);
-			m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+			m_pDeviceContext->ClearRenderTargetView(pRenderTargetView, &m_BackColor.r);
+			m_pDeviceContext->ClearDepthStencilView(pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
 
 			//2. Set Pipeline + Invoke DrawCalls
-			m_pVehicleMesh->Render(m_pDeviceContext);
+			if (m_pVehicleMesh && m_IsVehicleVisible)
+			{
+				m_pVehicleMesh->Render(m_pDeviceContext);
+			}
 
-			if (m_ShowFireMesh)
+			if (m_pFireMesh && m_ShowFireMesh && m_IsFireVisible)
 			{
 				m_pFireMesh->Render(m_pDeviceContext);
 			}
 
-			//3. Present Backbuffer (Swap)
-			m_pSwapChain->Present(0, 0);
+			//3. Resolve the samples into the swap chain buffer
+			if (useMultisampling)
+			{
+				m_pDeviceContext->ResolveSubresource(m_pRenderTargetBuffer, 0, m_pMultisampleRenderTargetBuffer, 0, DXGI_FORMAT_R8G8B8A8_UNORM);
+			}
+
+			//Waiting for the vertical blank is not render time, it would keep the dynamic resolution from going up
+			if (m_UseVSync) m_RenderMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			//4. Present Backbuffer (Swap), stretched to the window when the swap chain is smaller
+			m_pSwapChain->Present(m_UseVSync ? 1 : 0, 0);
 		}
 		else
 		{
 			std::cout << "DirectX not initialized!\n";
 		}
+
+		//The GPU runs behind, for DirectX this is the time to submit and present (which waits once the GPU falls behind)
+		if (!IsVSyncActive()) m_RenderMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		m_NrRenderAllocations = GetNrHeapAllocations() - nrAllocations;
+		return true;
+	}
+
+	void Renderer::Invalidate()
+	{
+		m_NrFramesToRender = m_NrFramesAfterChange;
+	}
+
+	void Renderer::SetVSync(bool useVSync)
+	{
+		m_UseVSync = useVSync;
+	}
+
+	bool Renderer::IsVSyncActive() const
+	{
+		return m_UseVSync && !m_IsSoftware && m_IsInitialized;
+	}
+
+	bool Renderer::IsLoaded() const
+	{
+		return m_pAssetManager->GetNrPendingLoads() == 0 && m_pVehicleMesh && m_pFireMesh;
+	}
+
+	uint64_t Renderer::GetNrRenderAllocations() const
+	{
+		return m_NrRenderAllocations;
+	}
+
+	const FrameBuffer<uint32_t>& Renderer::GetBackBuffer() const
+	{
+		return m_BackBuffer;
+	}
+
+	const SDL_PixelFormat* Renderer::GetBackBufferFormat() const
+	{
+		return m_pBackBuffer->format;
+	}
+
+	void Renderer::PrintStatistics() const
+	{
+		std::cout << "Resolution: " << m_RenderWidth << 'x' << m_RenderHeight << " (" << static_cast<int>(m_pResolutionController->GetScale() * 100.f + 0.5f) << "%), render "
+			<< m_RenderMilliseconds << " ms, budget " << m_pResolutionController->GetBudgetMilliseconds() << " ms"
+			<< (m_pResolutionController->IsEnabled() ? "\n" : " (dynamic resolution off)\n");
+
+		const auto printStatistics = [this](const char* pName, const Mesh* pMesh)
+		{
+			std::cout << pName << " instances: " << pMesh->GetNrVisibleInstances() << " visible\n";
+
+			//Levels of detail are selected for both rasterizers
+			const LODStatistics& lodStatistics{ pMesh->GetLODStatistics() };
+			const uint32_t nrSavedTriangles{ lodStatistics.nrFullDetailTriangles - lodStatistics.nrSelectedTriangles };
+
+			std::cout << pName << " LOD: " << lodStatistics.nrSelectedTriangles << " of " << lodStatistics.nrFullDetailTriangles << " triangles ("
+				<< (lodStatistics.nrFullDetailTriangles > 0 ? 100 * nrSavedTriangles / lodStatistics.nrFullDetailTriangles : 0) << "% saved), instances per level:";
+
+			for (uint32_t nrInstances : lodStatistics.nrInstances)
+			{
+				std::cout << ' ' << nrInstances;
+			}
+
+			std::cout << '\n';
+
+			//Culling only happens in the software rasterizer
+			if (!m_IsSoftware) return;
+
+			const CullStatistics& statistics{ pMesh->GetCullStatistics() };
+
+			std::cout << pName << " triangles: " << statistics.nrSubmitted << " submitted, "
+				<< statistics.nrFrustumCulled << " frustum culled, "
+				<< statistics.nrBackFaceCulled << " cull mode culled, "
+				<< statistics.nrDegenerate << " degenerate, "
+				<< statistics.nrVisible << " rasterized\n";
+		};
+
+		const auto printShadingStatistics = [this]()
+		{
+			if (!m_IsSoftware) return;
+
+			const ShadingStatistics& statistics{ m_pVehicleMesh->GetShadingStatistics() };
+
+			std::cout << "Vehicle shading: " << statistics.nrShadedPixels << " of " << statistics.nrVisiblePixels << " visible pixels shaded ("
+				<< (statistics.nrVisiblePixels > 0 ? 100 * (statistics.nrVisiblePixels - statistics.nrShadedPixels) / statistics.nrVisiblePixels : 0) << "% reused, "
+				<< statistics.nrReprojectedPixels << " from the last frame)\n";
+		};
+
+		if (!m_pVehicleMesh)
+		{
+			std::cout << "Vehicle: loading\n";
+		}
+		else if (m_IsVehicleVisible)
+		{
+			printStatistics("Vehicle", m_pVehicleMesh.get());
+			printShadingStatistics();
+		}
+		else
+		{
+			std::cout << "Vehicle: outside the frustum\n";
+		}
+
+		if (m_ShowFireMesh)
+		{
+			if (!m_pFireMesh)
+			{
+				std::cout << "FireFX: loading\n";
+			}
+			else if (m_IsFireVisible)
+			{
+				printStatistics("FireFX", m_pFireMesh.get());
+			}
+			else
+			{
+				std::cout << "FireFX: outside the frustum\n";
+			}
+		}
+
+		if (m_IsSoftware)
+		{
+			std::cout << "Frame arena: " << m_pFrameArena->GetUsedBytes() / 1024 << " KB used, " << m_pFrameArena->GetHighWaterMark() / 1024 << " KB peak, "
+				<< m_pFrameArena->GetCapacity() / 1024 << " KB capacity\n";
+		}
+
+		if (isCountingHeapAllocations) std::cout << "Heap allocations while rendering: " << m_NrRenderAllocations << '\n';
 	}
 
 	void Renderer::ToggleFilteringMethods()
 	{
+		Invalidate();
+
 
 
 		if (m_FilteringMethod == FilteringMethod::Anisotropic)
@@ -236,12 +464,14 @@ namespace dae {
 
 		std::cout << "----------------------------\n";
 
-		m_pVehicleMesh->SetSamplerState(pSamplerState);
-		m_pFireMesh->SetSamplerState(pSamplerState);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetSamplerState(pSamplerState);
+		if (m_pFireMesh) m_pFireMesh->SetSamplerState(pSamplerState);
 	}
 
 	void Renderer::ToggleRotation()
 	{
+		Invalidate();
+
 		m_ShouldRotate = !m_ShouldRotate;
 
 		std::cout << "----------------------------\n";
@@ -251,17 +481,24 @@ namespace dae {
 
 	void Renderer::ToggleVersion()
 	{
+		Invalidate();
+
 		m_IsSoftware = !m_IsSoftware;
 
 		std::cout << "----------------------------\n";
 		std::cout << "VERSION: " << (m_IsSoftware ? "SOFTWARE" : "HARDWARE") << '\n';
 		std::cout << "----------------------------\n";
 
+		//The other rasterizer has a different cost per pixel
+		m_pResolutionController->Reset();
+
 		SetBackColor();
 	}
 
 	void Renderer::ToggleCullMode()
 	{
+		Invalidate();
+
 		if (m_CullMode == CullMode::NoCulling)
 		{
 			m_CullMode = CullMode::BackFaceCulling;
@@ -294,11 +531,13 @@ namespace dae {
 		std::cout << "----------------------------\n";
 
 		//Only the vehicle has a cull mode that can be changed
-		m_pVehicleMesh->SetCullMode(m_CullMode, pRasterizerState);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetCullMode(m_CullMode, pRasterizerState);
 	}
 
 	void Renderer::ToggleUniformClearColor()
 	{
+		Invalidate();
+
 		m_IsUniformBackground = !m_IsUniformBackground;
 
 		std::cout << "----------------------------\n";
@@ -310,6 +549,8 @@ namespace dae {
 
 	void Renderer::ToggleFireMesh()
 	{
+		Invalidate();
+
 		m_ShowFireMesh = !m_ShowFireMesh;
 
 		std::cout << "----------------------------\n";
@@ -319,41 +560,49 @@ namespace dae {
 
 	void Renderer::ToggleUseNormalMap()
 	{
+		Invalidate();
+
 		m_UseNormalMap = !m_UseNormalMap;
 
 		std::cout << "----------------------------\n";
 		std::cout << "SOFTWARE: NORMAL MAP: " << (m_UseNormalMap ? "ON" : "OFF") << '\n';
 		std::cout << "----------------------------\n";
 
-		m_pVehicleMesh->SetUseNormalMap(m_UseNormalMap);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetUseNormalMap(m_UseNormalMap);
 	}
 
 	void Renderer::ToggleBoundingBoxVisualization()
 	{
+		Invalidate();
+
 		m_ShowBoundingBox = !m_ShowBoundingBox;
 
 		std::cout << "----------------------------\n";
 		std::cout << "SOFTWARE: BOUNDING BOX VISIBLE: " << (m_ShowBoundingBox ? "ON" : "OFF") << '\n';
 		std::cout << "----------------------------\n";
 
-		m_pVehicleMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
-		m_pFireMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
+		if (m_pFireMesh) m_pFireMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
 	}
 
 	void Renderer::ToggleDepthBufferVisualization()
 	{
+		Invalidate();
+
 		m_ShowDepth = !m_ShowDepth;
 
 		std::cout << "----------------------------\n";
 		std::cout << "SOFTWARE: DEPTH BUFFER VISIBLE: " << (m_ShowDepth ? "ON" : "OFF") << '\n';
 		std::cout << "----------------------------\n";
 
-		m_pVehicleMesh->SetDepthVisibility(m_ShowDepth);
-		m_pFireMesh->SetDepthVisibility(m_ShowDepth);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetDepthVisibility(m_ShowDepth);
+		if (m_pFireMesh) m_pFireMesh->SetDepthVisibility(m_ShowDepth);
 	}
 
 	void Renderer::ToggleRenderMode()
 	{
+		Invalidate();
+
 		if (m_RenderMode == RenderMode::Specular)
 		{
 			m_RenderMode = RenderMode::Combined;
@@ -385,14 +634,256 @@ namespace dae {
 		std::cout << "----------------------------\n";
 
 		//Only the vehicle has a render mode that can be changed
-		m_pVehicleMesh->SetRenderMode(m_RenderMode);
+		if (m_pVehicleMesh) m_pVehicleMesh->SetRenderMode(m_RenderMode);
 	}
 
-	void Renderer::PrintStartInfo()
+	void Renderer::ToggleShadingQuality()
+	{
+		Invalidate();
+
+		if (m_ShadingQuality == ShadingQuality::LookupTable)
+		{
+			m_ShadingQuality = ShadingQuality::Precise;
+		}
+		else
+		{
+			m_ShadingQuality = static_cast<ShadingQuality>(static_cast<int>(m_ShadingQuality) + 1);
+		}
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: SHADING QUALITY: ";
+
+		switch (m_ShadingQuality)
+		{
+		case ShadingQuality::Precise:
+			std::cout << "PRECISE\n";
+			break;
+		case ShadingQuality::Fast:
+			std::cout << "FAST MATH\n";
+			break;
+		case ShadingQuality::LookupTable:
+			std::cout << "SPECULAR LOOKUP TABLE\n";
+			break;
+		}
+
+		std::cout << "----------------------------\n";
+
+		//Only the vehicle uses lighting
+		if (m_pVehicleMesh) m_pVehicleMesh->SetShadingQuality(m_ShadingQuality);
+	}
+
+	void Renderer::ToggleShadingRate()
+	{
+		Invalidate();
+
+		if (m_ShadingRate == ShadingRate::Adaptive)
+		{
+			m_ShadingRate = ShadingRate::Rate1x1;
+		}
+		else
+		{
+			m_ShadingRate = static_cast<ShadingRate>(static_cast<int>(m_ShadingRate) + 1);
+		}
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: SHADING RATE: ";
+
+		switch (m_ShadingRate)
+		{
+		case ShadingRate::Rate1x1:
+			std::cout << "1x1\n";
+			break;
+		case ShadingRate::Rate1x2:
+			std::cout << "1x2\n";
+			break;
+		case ShadingRate::Rate2x1:
+			std::cout << "2x1\n";
+			break;
+		case ShadingRate::Rate2x2:
+			std::cout << "2x2\n";
+			break;
+		case ShadingRate::Rate4x4:
+			std::cout << "4x4\n";
+			break;
+		case ShadingRate::Adaptive:
+			std::cout << "ADAPTIVE (PER " << ShadingRateImage::tileSize << "x" << ShadingRateImage::tileSize << " TILE)\n";
+			break;
+		}
+
+		std::cout << "----------------------------\n";
+
+		//Only the vehicle uses lighting, the fire is cheap to shade
+		if (m_pVehicleMesh) m_pVehicleMesh->SetShadingRate(m_ShadingRate);
+	}
+
+	void Renderer::ToggleTemporalCache()
+	{
+		Invalidate();
+
+		m_UseTemporalCache = !m_UseTemporalCache;
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: TEMPORAL SHADING CACHE: " << (m_UseTemporalCache ? "ON" : "OFF") << '\n';
+		std::cout << "----------------------------\n";
+
+		if (m_pVehicleMesh) m_pVehicleMesh->SetUseTemporalCache(m_UseTemporalCache);
+	}
+
+	void Renderer::ToggleHud()
+	{
+		Invalidate();
+
+		m_ShowHud = !m_ShowHud;
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: STATISTICS HUD: " << (m_ShowHud ? "ON" : "OFF") << '\n';
+		std::cout << "----------------------------\n";
+	}
+
+	void Renderer::ToggleHeatmap()
+	{
+		Invalidate();
+
+		if (m_HeatmapMode == HeatmapMode::TileTime)
+		{
+			m_HeatmapMode = HeatmapMode::Off;
+		}
+		else
+		{
+			m_HeatmapMode = static_cast<HeatmapMode>(static_cast<int>(m_HeatmapMode) + 1);
+		}
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: HEATMAP: ";
+
+		switch (m_HeatmapMode)
+		{
+		case HeatmapMode::Off:
+			std::cout << "OFF\n";
+			break;
+		case HeatmapMode::Overdraw:
+			std::cout << "OVERDRAW (FRAGMENTS PER PIXEL)\n";
+			break;
+		case HeatmapMode::DepthFails:
+			std::cout << "DEPTH TEST FAILS (SAMPLES PER PIXEL)\n";
+			break;
+		case HeatmapMode::ShadingCost:
+			std::cout << "SHADING CYCLES PER PIXEL\n";
+			break;
+		case HeatmapMode::TileTime:
+			std::cout << "RASTER CYCLES PER " << Heatmap::tileSize << "x" << Heatmap::tileSize << " TILE\n";
+			break;
+		}
+
+		std::cout << "----------------------------\n";
+
+		Heatmap* pHeatmap{ m_HeatmapMode != HeatmapMode::Off ? m_pHeatmap.get() : nullptr };
+		if (m_pVehicleMesh) m_pVehicleMesh->SetHeatmap(pHeatmap);
+		if (m_pFireMesh) m_pFireMesh->SetHeatmap(pHeatmap);
+	}
+
+	void Renderer::ToggleTiledLayout()
+	{
+		Invalidate();
+
+		m_UseTiledLayout = !m_UseTiledLayout;
+
+		std::cout << "----------------------------\n";
+		std::cout << "SOFTWARE: FRAME BUFFER LAYOUT: " << (m_UseTiledLayout ? "8X8 TILES" : "LINEAR") << '\n';
+		std::cout << "----------------------------\n";
+	}
+
+	void Renderer::ToggleInstancing()
+	{
+		Invalidate();
+
+		//The grid spacing depends on the size of the vehicle
+		if (!m_pVehicleMesh) return;
+
+		m_IsInstancing = !m_IsInstancing;
+
+		if (m_IsInstancing)
+		{
+			//Leave a gap of a quarter vehicle between the instances
+			const BoundingBox& boundingBox{ m_pVehicleMesh->GetBoundingBox() };
+			const float spacing{ 1.25f * std::max(boundingBox.max.x - boundingBox.min.x, boundingBox.max.z - boundingBox.min.z) };
+
+			m_pScene->CreateGrid(m_NrInstanceColumns, m_NrInstanceRows, spacing);
+		}
+		else
+		{
+			m_pScene->CreateSingle();
+		}
+
+		std::cout << "----------------------------\n";
+		std::cout << "INSTANCES: " << m_pScene->GetNrInstances() << '\n';
+		std::cout << "----------------------------\n";
+	}
+
+	void Renderer::ToggleVertexFormat()
+	{
+		Invalidate();
+
+		m_VertexFormat = m_VertexFormat == VertexFormat::Full ? VertexFormat::Compressed : VertexFormat::Full;
+
+		std::cout << "----------------------------\n";
+		std::cout << "VERTEX FORMAT: ";
+
+		switch (m_VertexFormat)
+		{
+		case VertexFormat::Full:
+			std::cout << "FULL (" << sizeof(Vertex) << " bytes)\n";
+			break;
+		case VertexFormat::Compressed:
+			std::cout << "COMPRESSED (" << sizeof(CompressedVertex) << " bytes)\n";
+			break;
+		}
+
+		std::cout << "----------------------------\n";
+
+		//The vertex buffers are immutable, CreateLoadedMeshes recreates the meshes with the new format.
+		//Update gives them the current rotation (m_RotationAngle) before they are rendered, so the model doesn't jump back
+		m_pVehicleMesh.reset();
+		m_pFireMesh.reset();
+	}
+
+	void Renderer::ToggleMultisampling()
 	{
-		system("cls");
+		Invalidate();
+
+		//The sample planes are allocated by the next frame
+		m_UseMultisampling = !m_UseMultisampling;
+
+		std::cout << "----------------------------\n";
+		std::cout << "MSAA: " << (m_UseMultisampling ? "4X" : "OFF") << '\n';
+
+		if (m_UseMultisampling && !m_pMultisampleDepthStencilView)
+		{
+			std::cout << "HARDWARE: 4X MSAA NOT SUPPORTED\n";
+		}
 
 		std::cout << "----------------------------\n";
+	}
+
+	void Renderer::ToggleDynamicResolution()
+	{
+		Invalidate();
+
+		const bool isEnabled{ !m_pResolutionController->IsEnabled() };
+
+		if (m_pResolutionController->SetEnabled(isEnabled))
+		{
+			ApplyRenderResolution();
+		}
+
+		std::cout << "----------------------------\n";
+		std::cout << "DYNAMIC RESOLUTION: " << (isEnabled ? "ON" : "OFF") << " (" << m_pResolutionController->GetBudgetMilliseconds() << " ms budget)\n";
+		std::cout << "----------------------------\n";
+	}
+
+	void Renderer::PrintStartInfo()
+	{
+		std::cout << "----------------------------\n";
 		std::cout << "SHARED\n" "----------------------------\n";
 		std::cout << "('F1') Toggle between DirectX & Software Rasterizer\n";
 		std::cout << "('F2') Toggle Rotation (On/Off)\n";
@@ -400,6 +891,11 @@ namespace dae {
 		std::cout << "('F10') Toggle Uniform ClearColor (On/Off)\n";
 		std::cout << "('F11') Toggle Print FPS (On/Off)\n";
 		std::cout << "('F3') Toggle FireFX mesh (On/Off)\n";
+		std::cout << "('I') Toggle Instance Grid (1 / " << m_NrInstanceColumns * m_NrInstanceRows << " vehicles)\n";
+		std::cout << "('V') Toggle Compressed Vertex Format (" << sizeof(Vertex) << " / " << sizeof(CompressedVertex) << " bytes per vertex)\n";
+		std::cout << "('M') Toggle 4x MSAA (On/Off)\n";
+		std::cout << "('R') Toggle Dynamic Resolution (On/Off)\n";
+		std::cout << "('P') Cycle Frame Pacing (Uncapped / 60 FPS / VSync)\n";
 
 		std::cout << "----------------------------\n";
 		std::cout << "HARDWARE\n" "----------------------------\n";
@@ -411,6 +907,12 @@ namespace dae {
 		std::cout << "('F6') Toggle NormalMap (On/Off)\n";
 		std::cout << "('F7') Toggle DepthBuffer Visualization (On/Off)\n";
 		std::cout << "('F8') Toggle BoundingBox Visualization (On/Off)\n";
+		std::cout << "('F12') Cycle Shading Quality (Precise / Fast Math / Specular Lookup Table)\n";
+		std::cout << "('C') Cycle Shading Rate (1x1 / 1x2 / 2x1 / 2x2 / 4x4 / Adaptive)\n";
+		std::cout << "('T') Toggle Temporal Shading Cache (On/Off)\n";
+		std::cout << "('H') Toggle Statistics HUD (On/Off)\n";
+		std::cout << "('G') Cycle Heatmap (Off / Overdraw / Depth Test Fails / Shading Cycles / Tile Cycles)\n";
+		std::cout << "('L') Toggle Frame Buffer Layout (Linear / 8x8 Tiles)\n";
 
 		std::cout << "----------------------------\n";
 		std::cout << "EXTRA FEATURE\n" "----------------------------\n";
@@ -433,6 +935,202 @@ namespace dae {
 		}
 	}
 
+	void Renderer::CreateLoadedMeshes()
+	{
+		if (!m_pVehicleMesh && m_VehicleMeshData.IsReady() && m_OpaqueEffect.IsReady()
+			&& m_DiffuseMap.IsReady() && m_NormalMap.IsReady() && m_SpecularMap.IsReady() && m_GlossinessMap.IsReady())
+		{
+			const std::shared_ptr<MeshData> pMeshData{ m_VehicleMeshData.Get() };
+
+			//Failed loads are nullptr, the mesh is not created without all of its assets
+			if (pMeshData && m_DiffuseMap.Get() && m_NormalMap.Get() && m_SpecularMap.Get() && m_GlossinessMap.Get())
+			{
+				Invalidate();
+				m_pVehicleMesh = std::make_unique<MeshOpaque>(m_pDevice, *pMeshData, m_VertexFormat, m_DiffuseMap.Get().get(), m_NormalMap.Get().get(), m_SpecularMap.Get().get(), m_GlossinessMap.Get().get());
+
+				m_pVehicleMesh->SetMatrices(m_pCamera.get());
+				m_pVehicleMesh->SetSamplerState(GetSamplerState());
+				m_pVehicleMesh->SetCullMode(m_CullMode, GetRasterizerState());
+				m_pVehicleMesh->SetUseNormalMap(m_UseNormalMap);
+				m_pVehicleMesh->SetRenderMode(m_RenderMode);
+				m_pVehicleMesh->SetShadingQuality(m_ShadingQuality);
+				m_pVehicleMesh->SetShadingRate(m_ShadingRate);
+				m_pVehicleMesh->SetShadingRateImage(m_pShadingRateImage.get());
+				m_pVehicleMesh->SetUseTemporalCache(m_UseTemporalCache);
+				m_pVehicleMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
+				m_pVehicleMesh->SetDepthVisibility(m_ShowDepth);
+				m_pVehicleMesh->SetHeatmap(m_HeatmapMode != HeatmapMode::Off ? m_pHeatmap.get() : nullptr);
+			}
+		}
+
+		if (!m_pFireMesh && m_FireMeshData.IsReady() && m_TransparentEffect.IsReady() && m_FireDiffuseMap.IsReady())
+		{
+			const std::shared_ptr<MeshData> pMeshData{ m_FireMeshData.Get() };
+
+			if (pMeshData && m_FireDiffuseMap.Get())
+			{
+				Invalidate();
+				m_pFireMesh = std::make_unique<MeshTransparent>(m_pDevice, *pMeshData, m_VertexFormat, m_FireDiffuseMap.Get().get());
+
+				m_pFireMesh->SetMatrices(m_pCamera.get());
+				m_pFireMesh->SetSamplerState(GetSamplerState());
+				m_pFireMesh->SetRasterizerState(m_pRasterizer->GetRasterizerState(D3D11_CULL_NONE));
+				m_pFireMesh->SetBoundingBoxVisibitily(m_ShowBoundingBox);
+				m_pFireMesh->SetDepthVisibility(m_ShowDepth);
+				m_pFireMesh->SetHeatmap(m_HeatmapMode != HeatmapMode::Off ? m_pHeatmap.get() : nullptr);
+			}
+		}
+	}
+
+	ID3D11SamplerState* Renderer::GetSamplerState() const
+	{
+		switch (m_FilteringMethod)
+		{
+		case FilteringMethod::Point:
+			return m_pSampler->GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_POINT);
+		case FilteringMethod::Linear:
+			return m_pSampler->GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR);
+		default:
+			return m_pSampler->GetSamplerState(D3D11_FILTER_ANISOTROPIC);
+		}
+	}
+
+	void Renderer::DrawHud()
+	{
+		const bool isVehicleRendered{ m_pVehicleMesh && m_IsVehicleVisible };
+		const bool isFireRendered{ m_pFireMesh && m_ShowFireMesh && m_IsFireVisible };
+
+		m_pHud->AddLine("RENDER %dX%d (%d%%) %.2f MS, MSAA %s", m_RenderWidth, m_RenderHeight,
+			static_cast<int>(m_pResolutionController->GetScale() * 100.f + 0.5f), m_RenderMilliseconds, m_UseMultisampling ? "4X" : "OFF");
+
+		//Triangles of both meshes
+		CullStatistics triangles{};
+		const auto addTriangles = [&triangles](const Mesh* pMesh)
+		{
+			const CullStatistics& statistics{ pMesh->GetCullStatistics() };
+
+			triangles.nrSubmitted += statistics.nrSubmitted;
+			triangles.nrFrustumCulled += statistics.nrFrustumCulled;
+			triangles.nrBackFaceCulled += statistics.nrBackFaceCulled;
+			triangles.nrDegenerate += statistics.nrDegenerate;
+			triangles.nrVisible += statistics.nrVisible;
+		};
+
+		if (isVehicleRendered) addTriangles(m_pVehicleMesh.get());
+		if (isFireRendered) addTriangles(m_pFireMesh.get());
+
+		m_pHud->AddLine("TRIANGLES %u, CULLED %u, RASTERIZED %u", triangles.nrSubmitted,
+			triangles.nrFrustumCulled + triangles.nrBackFaceCulled + triangles.nrDegenerate, triangles.nrVisible);
+
+		//The covered pixels are counted by the raster loop, the HUD doesn't scan the depth buffer
+		if (isVehicleRendered)
+		{
+			const ShadingStatistics& shading{ m_pVehicleMesh->GetShadingStatistics() };
+			const uint32_t nrCoveredPixels{ shading.nrCoveredPixels };
+
+			m_pHud->AddLine("PIXELS %u, SHADED %u, REPROJECTED %u", shading.nrVisiblePixels, shading.nrShadedPixels, shading.nrReprojectedPixels);
+			m_pHud->AddLine("OVERDRAW %.2f OVER %u PIXELS", nrCoveredPixels > 0 ? static_cast<float>(shading.nrVisiblePixels) / nrCoveredPixels : 0.f, nrCoveredPixels);
+		}
+
+		if (m_HeatmapMode != HeatmapMode::Off)
+		{
+			constexpr const char* modeNames[]{ "OFF", "OVERDRAW", "DEPTH FAILS", "SHADING CYCLES", "TILE CYCLES" };
+
+			m_pHud->AddLine("HEATMAP %s: RED AT %llu, TOTAL %llu", modeNames[static_cast<int>(m_HeatmapMode)],
+				static_cast<unsigned long long>(m_pHeatmap->GetScale()), static_cast<unsigned long long>(m_pHeatmap->GetTotal(m_HeatmapMode)));
+		}
+
+		//The size of the worker pool, how busy the workers are is not measured
+		m_pHud->AddLine("WORKER POOL %d THREADS, %d LOADS PENDING", GetNrWorkers(), static_cast<int>(m_pAssetManager->GetNrPendingLoads()));
+
+		//Memory per subsystem, in MB
+		const size_t frameBytes{ m_BackBuffer.GetMemoryUsage() + m_ColorTarget.GetMemoryUsage() + m_DepthTarget.GetMemoryUsage() };
+
+		size_t meshBytes{};
+		if (m_pVehicleMesh) meshBytes += m_pVehicleMesh->GetMemoryUsage();
+		if (m_pFireMesh) meshBytes += m_pFireMesh->GetMemoryUsage();
+
+		size_t textureBytes{};
+		for (const AssetHandle<Texture>* pTexture : { &m_DiffuseMap, &m_NormalMap, &m_SpecularMap, &m_GlossinessMap, &m_FireDiffuseMap })
+		{
+			if (pTexture->IsReady() && pTexture->Get()) textureBytes += pTexture->Get()->GetMemoryUsage();
+		}
+
+		constexpr float bytesPerMegabyte{ 1024.f * 1024.f };
+		m_pHud->AddLine("MEMORY MB: FRAME %.1f, MESH %.1f, TEXTURE %.1f", frameBytes / bytesPerMegabyte, meshBytes / bytesPerMegabyte, textureBytes / bytesPerMegabyte);
+		if (isCountingHeapAllocations)
+		{
+			m_pHud->AddLine("ARENA KB: USED %zu, PEAK %zu, HEAP ALLOCATIONS %llu", m_pFrameArena->GetUsedBytes() / 1024, m_pFrameArena->GetHighWaterMark() / 1024,
+				static_cast<unsigned long long>(m_NrRenderAllocations));
+		}
+		else
+		{
+			m_pHud->AddLine("ARENA KB: USED %zu, PEAK %zu", m_pFrameArena->GetUsedBytes() / 1024, m_pFrameArena->GetHighWaterMark() / 1024);
+		}
+
+		if (SDL_MUSTLOCK(m_pFrontBuffer)) SDL_LockSurface(m_pFrontBuffer);
+		m_pHud->Draw(m_pFrontBuffer, m_FrameBudgetMilliseconds);
+		if (SDL_MUSTLOCK(m_pFrontBuffer)) SDL_UnlockSurface(m_pFrontBuffer);
+	}
+
+	void Renderer::ResolveColorTarget()
+	{
+		static_assert(m_NrMultisamples == 4, "The resolve averages four sample planes");
+
+		const FrameBufferLayout& sourceLayout{ m_ColorTarget.GetLayout() };
+		const FrameBufferLayout& destinationLayout{ m_BackBuffer.GetLayout() };
+		const uint32_t* pSource{ m_ColorTarget.GetPixels() };
+		uint32_t* pDestination{ m_BackBuffer.GetPixels() };
+		const bool isMultisampled{ m_ColorTarget.GetNrSamples() > 1 };
+
+		//Four pixels at a time, they are next to each other and 16 byte aligned in both layouts.
+		//The last ones of a row can be padding, both buffers have it
+		for (int py{}; py < m_RenderHeight; ++py)
+		{
+			for (int px{}; px < m_RenderWidth; px += 4)
+			{
+				const uint32_t* pPixels{ pSource + sourceLayout.GetIndex(px, py) };
+				__m128i color{ _mm_load_si128(reinterpret_cast<const __m128i*>(pPixels)) };
+
+				//Per channel average of every byte
+				if (isMultisampled)
+				{
+					const int planeSize{ sourceLayout.planeSize };
+					const __m128i sample1{ _mm_load_si128(reinterpret_cast<const __m128i*>(pPixels + planeSize)) };
+					const __m128i sample2{ _mm_load_si128(reinterpret_cast<const __m128i*>(pPixels + 2 * planeSize)) };
+					const __m128i sample3{ _mm_load_si128(reinterpret_cast<const __m128i*>(pPixels + 3 * planeSize)) };
+
+					color = _mm_avg_epu8(_mm_avg_epu8(color, sample1), _mm_avg_epu8(sample2, sample3));
+				}
+
+				_mm_store_si128(reinterpret_cast<__m128i*>(pDestination + destinationLayout.GetIndex(px, py)), color);
+			}
+		}
+	}
+
+	void Renderer::CreateBackBuffer()
+	{
+		m_BackBuffer.Resize(m_RenderWidth, m_RenderHeight, 1, false);
+
+		//The pitch is the padded row, SDL doesn't free the pixels of the surface
+		if (m_pBackBuffer) SDL_FreeSurface(m_pBackBuffer);
+		m_pBackBuffer = SDL_CreateRGBSurfaceFrom(m_BackBuffer.GetPixels(), m_RenderWidth, m_RenderHeight, 32,
+			m_BackBuffer.GetLayout().tileRowPitch * static_cast<int>(sizeof(uint32_t)), 0, 0, 0, 0);
+	}
+
+	ID3D11RasterizerState* Renderer::GetRasterizerState() const
+	{
+		switch (m_CullMode)
+		{
+		case CullMode::FrontFaceCulling:
+			return m_pRasterizer->GetRasterizerState(D3D11_CULL_FRONT);
+		case CullMode::BackFaceCulling:
+			return m_pRasterizer->GetRasterizerState(D3D11_CULL_BACK);
+		default:
+			return m_pRasterizer->GetRasterizerState(D3D11_CULL_NONE);
+		}
+	}
+
 	HRESULT Renderer::InitializeDirectX()
 	{
 		//1. Create Device & DeviceContext
@@ -479,11 +1177,31 @@ namespace dae {
 		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc,&m_pSwapChain);
 		if (FAILED(result)) return result;
 
+		if (pDxgiFactory)
+		{
+			pDxgiFactory->Release();
+		}
+
+		//3-6. Targets of the render resolution
+		result = CreateRenderTargets();
+		if (FAILED(result)) return result;
+
+		//Optional, without it the hardware rasterizer ignores multisampling
+		if (!m_pMultisampleDepthStencilView)
+		{
+			std::cout << "4x MSAA is not supported by the DirectX device\n";
+		}
+
+		return result;
+	}
+
+	HRESULT Renderer::CreateRenderTargets()
+	{
 		//3. Create DepthStencil (DS) & DepthStencilView (DSV)
 		//Resource
 		D3D11_TEXTURE2D_DESC depthStencilDesc{};
-		depthStencilDesc.Width = m_Width;
-		depthStencilDesc.Height = m_Height;
+		depthStencilDesc.Width = m_RenderWidth;
+		depthStencilDesc.Height = m_RenderHeight;
 		depthStencilDesc.MipLevels = 1;
 		depthStencilDesc.ArraySize = 1;
 		depthStencilDesc.Format = DXGI_FORMAT_D32_FLOAT;
@@ -500,7 +1218,7 @@ namespace dae {
 		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
 		depthStencilViewDesc.Texture2D.MipSlice = 0;
 		
-		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
+		HRESULT result{ m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer) };
 		if (FAILED(result)) return result;
 
 		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
@@ -515,24 +1233,111 @@ namespace dae {
 		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
 		if (FAILED(result)) return result;
 
+		//Optional, without it the hardware rasterizer ignores multisampling
+		CreateMultisampleTargets();
+
 		//5. Bind RTV & DSV to Output Merger Stage
 		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
 
 		//6. Set Viewport --- Shared screen possible with multiple viewports
 		D3D11_VIEWPORT viewport{};
-		viewport.Width = static_cast<float>(m_Width);
-		viewport.Height = static_cast<float>(m_Height);
+		viewport.Width = static_cast<float>(m_RenderWidth);
+		viewport.Height = static_cast<float>(m_RenderHeight);
 		viewport.TopLeftX = 0.f;
 		viewport.TopLeftY = 0.f;
 		viewport.MinDepth = 0.f;
 		viewport.MaxDepth = 1.f;
 		m_pDeviceContext->RSSetViewports(1, &viewport);
 
-		if (pDxgiFactory)
+		return result;
+	}
+
+	void Renderer::ReleaseRenderTargets()
+	{
+		const auto release = [](auto*& pResource)
 		{
-			pDxgiFactory->Release();
+			if (pResource)
+			{
+				pResource->Release();
+				pResource = nullptr;
+			}
+		};
+
+		release(m_pMultisampleDepthStencilView);
+		release(m_pMultisampleDepthStencilBuffer);
+		release(m_pMultisampleRenderTargetView);
+		release(m_pMultisampleRenderTargetBuffer);
+
+		release(m_pRenderTargetView);
+		release(m_pRenderTargetBuffer);
+		release(m_pDepthStencilView);
+		release(m_pDepthStencilBuffer);
+	}
+
+	void Renderer::ApplyRenderResolution()
+	{
+		Invalidate();
+
+		m_RenderWidth = m_pResolutionController->GetWidth();
+		m_RenderHeight = m_pResolutionController->GetHeight();
+
+		//Software, the buffers keep the memory of the window size and only use part of it
+		CreateBackBuffer();
+
+		//DirectX, the swap chain buffer can only be resized once nothing refers to it
+		if (!m_IsInitialized) return;
+
+		m_pDeviceContext->OMSetRenderTargets(0, nullptr, nullptr);
+		ReleaseRenderTargets();
+
+		HRESULT result{ m_pSwapChain->ResizeBuffers(1, m_RenderWidth, m_RenderHeight, DXGI_FORMAT_R8G8B8A8_UNORM, 0) };
+		if (SUCCEEDED(result)) result = CreateRenderTargets();
+
+		if (FAILED(result))
+		{
+			m_IsInitialized = false;
+			std::cout << "DirectX failed to resize the render targets!\n";
 		}
+	}
 
-		return result;
+	HRESULT Renderer::CreateMultisampleTargets()
+	{
+		//Not every device supports every sample count for a format
+		UINT nrQualityLevels{};
+		HRESULT result{ m_pDevice->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, m_NrMultisamples, &nrQualityLevels) };
+		if (FAILED(result) || nrQualityLevels == 0) return E_FAIL;
+
+		//Render target, same format as the swap chain so it can be resolved into it
+		D3D11_TEXTURE2D_DESC textureDesc{};
+		textureDesc.Width = m_RenderWidth;
+		textureDesc.Height = m_RenderHeight;
+		textureDesc.MipLevels = 1;
+		textureDesc.ArraySize = 1;
+		textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		textureDesc.SampleDesc.Count = m_NrMultisamples;
+		textureDesc.SampleDesc.Quality = 0;
+		textureDesc.Usage = D3D11_USAGE_DEFAULT;
+		textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+		textureDesc.CPUAccessFlags = 0;
+		textureDesc.MiscFlags = 0;
+
+		result = m_pDevice->CreateTexture2D(&textureDesc, nullptr, &m_pMultisampleRenderTargetBuffer);
+		if (FAILED(result)) return result;
+
+		result = m_pDevice->CreateRenderTargetView(m_pMultisampleRenderTargetBuffer, nullptr, &m_pMultisampleRenderTargetView);
+		if (FAILED(result)) return result;
+
+		//Depth stencil, a depth per sample
+		textureDesc.Format = DXGI_FORMAT_D32_FLOAT;
+		textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+		depthStencilViewDesc.Format = textureDesc.Format;
+		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DMS;
+
+		result = m_pDevice->CreateTexture2D(&textureDesc, nullptr, &m_pMultisampleDepthStencilBuffer);
+		if (FAILED(result)) return result;
+
+		return m_pDevice->CreateDepthStencilView(m_pMultisampleDepthStencilBuffer, &depthStencilViewDesc, &m_pMultisampleDepthStencilView);
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "DataTypes.h"
+#include "AssetManager.h"
+#include "FrameBuffer.h"
 struct SDL_Window;
 struct SDL_Surface;
 struct Vertex;
@@ -9,11 +11,18 @@ class Rasterizer;
 class MeshOpaque;
 class MeshTransparent;
 class Texture;
+class Scene;
+class ResolutionController;
+struct MeshData;
 
 
 namespace dae
 {
 	struct Camera;
+	class ShadingRateImage;
+	class Hud;
+	class Heatmap;
+	class FrameArena;
 
 	class Renderer final
 	{
@@ -27,7 +36,23 @@ namespace dae
 		Renderer& operator=(Renderer&&) noexcept = delete;
 
 		void Update(const Timer* pTimer);
-		void Render() const;
+		//Returns false when nothing changed since the last frames, they are still on screen
+		bool Render();
+		//Renders the next frames, for changes the renderer can't see (the window was uncovered)
+		void Invalidate();
+
+		//DirectX presents on the vertical blank, the software rasterizer can't (see FramePacer)
+		void SetVSync(bool useVSync);
+		bool IsVSyncActive() const;
+		void PrintStatistics() const;
+
+		//Every asset finished loading and the meshes are created (see CreateLoadedMeshes)
+		bool IsLoaded() const;
+		//operator new calls during the last rendered frame, only counted with COUNT_HEAP_ALLOCATIONS (see AllocationCounter.h)
+		uint64_t GetNrRenderAllocations() const;
+		//Software, the colors of the last frame
+		const FrameBuffer<uint32_t>& GetBackBuffer() const;
+		const SDL_PixelFormat* GetBackBufferFormat() const;
 
 		void ToggleFilteringMethods();
 		void ToggleRotation();
@@ -39,6 +64,16 @@ namespace dae
 		void ToggleBoundingBoxVisualization();
 		void ToggleDepthBufferVisualization();
 		void ToggleRenderMode();
+		void ToggleShadingQuality();
+		void ToggleShadingRate();
+		void ToggleTemporalCache();
+		void ToggleHud();
+		void ToggleHeatmap();
+		void ToggleTiledLayout();
+		void ToggleInstancing();
+		void ToggleVertexFormat();
+		void ToggleMultisampling();
+		void ToggleDynamicResolution();
 
 	private:
 
@@ -49,6 +84,23 @@ namespace dae
 		void PrintStartInfo();
 		void SetBackColor();
 
+		//Creates the meshes once all their assets are loaded, with the current settings
+		void CreateLoadedMeshes();
+		ID3D11SamplerState* GetSamplerState() const;
+
+		//Averages the sample planes of the color target into the back buffer (copies a single one), four pixels at a time
+		void ResolveColorTarget();
+
+		//Software, over the window surface so it keeps its size with dynamic resolution
+		void DrawHud();
+
+		//Sizes the software back buffer to the render resolution, the SDL surface wraps its memory
+		void CreateBackBuffer();
+
+		//Resizes the software back buffer and the DirectX targets to the resolution of the controller
+		void ApplyRenderResolution();
+		ID3D11RasterizerState* GetRasterizerState() const;
+
 		////////////////////////////////////////////////////
 		//	Variables
 		////////////////////////////////////////////////////
@@ -59,38 +111,89 @@ namespace dae
 		int m_Width{};
 		int m_Height{};
 
+		//Dynamic resolution, rendered at this size and stretched to the window when presenting
+		int m_RenderWidth{};
+		int m_RenderHeight{};
+		const float m_FrameBudgetMilliseconds{ 1000.f / 60.f };
+		float m_RenderMilliseconds{};
+		std::unique_ptr<ResolutionController> m_pResolutionController;
+
+		//Change tracking, a change renders a few frames so the temporal cache and the adaptive shading rates settle
+		static constexpr int m_NrFramesAfterChange{ 4 };
+		int m_NrFramesToRender{ m_NrFramesAfterChange };
+		bool m_IsFrameRendered{ true };
+
+		bool m_UseVSync{ false };
+
+		//Transient memory of the software pipeline, reset at the start of every frame. Grows to the biggest frame once
+		std::unique_ptr<FrameArena> m_pFrameArena;
+		static constexpr size_t m_FrameArenaCapacity{ 1 << 20 };
+
+		//operator new calls during the last rendered frame (see AllocationCounter.h), zero once the buffers have grown
+		uint64_t m_NrRenderAllocations{};
+
+		//Statistics overlay, software only
+		std::unique_ptr<Hud> m_pHud;
+		bool m_ShowHud{ false };
+
 		//Software
 		SDL_Surface* m_pFrontBuffer{ nullptr };
 		SDL_Surface* m_pBackBuffer{ nullptr };
-		uint32_t* m_pBackBufferPixels{};
+		FrameBuffer<uint32_t> m_BackBuffer{};
+
+		//Render targets, sized every frame and only reallocated when they grow. The meshes render into the back buffer directly
+		//when it has the layout of the depth target (one sample, linear), the color target is resolved into it otherwise
+		FrameBuffer<uint32_t> m_ColorTarget{};
+		FrameBuffer<float> m_DepthTarget{};
+		bool m_UseTiledLayout{ false };
 
-		float* m_pDepthBufferPixels{};
+		//Multisampling, one plane per sample (see TriangleSamples)
+		static constexpr int m_NrMultisamples{ 4 };
+		bool m_UseMultisampling{ false };
 
 		//DIRECTX
 		HRESULT InitializeDirectX();
+		HRESULT CreateRenderTargets();
+		HRESULT CreateMultisampleTargets();
+		void ReleaseRenderTargets();
 		bool m_IsInitialized{ false };
 
-		ID3D11Device* m_pDevice;
-		ID3D11DeviceContext* m_pDeviceContext;
+		ID3D11Device* m_pDevice{};
+		ID3D11DeviceContext* m_pDeviceContext{};
 
-		IDXGISwapChain* m_pSwapChain;
+		IDXGISwapChain* m_pSwapChain{};
 
-		ID3D11Texture2D* m_pDepthStencilBuffer;
-		ID3D11DepthStencilView* m_pDepthStencilView;
+		//Render resolution, recreated when it changes
+		ID3D11Texture2D* m_pDepthStencilBuffer{};
+		ID3D11DepthStencilView* m_pDepthStencilView{};
 
-		ID3D11Resource* m_pRenderTargetBuffer;
-		ID3D11RenderTargetView* m_pRenderTargetView;
+		ID3D11Resource* m_pRenderTargetBuffer{};
+		ID3D11RenderTargetView* m_pRenderTargetView{};
+
+		//Resolved into the swap chain buffer before presenting, the depth stencil view is nullptr when the device doesn't support 4x
+		ID3D11Texture2D* m_pMultisampleRenderTargetBuffer{};
+		ID3D11RenderTargetView* m_pMultisampleRenderTargetView{};
+		ID3D11Texture2D* m_pMultisampleDepthStencilBuffer{};
+		ID3D11DepthStencilView* m_pMultisampleDepthStencilView{};
 
 		//Camera
 		std::unique_ptr<Camera> m_pCamera;
 
-		//Textures
-		std::unique_ptr<Texture> m_pDiffuseMap;
-		std::unique_ptr<Texture> m_pNormalMap;
-		std::unique_ptr<Texture> m_pSpecularMap;
-		std::unique_ptr<Texture> m_pGlossinessMap;
+		//Assets, loaded in the background and kept alive by the asset manager
+		std::unique_ptr<AssetManager> m_pAssetManager;
+
+		AssetHandle<Texture> m_DiffuseMap;
+		AssetHandle<Texture> m_NormalMap;
+		AssetHandle<Texture> m_SpecularMap;
+		AssetHandle<Texture> m_GlossinessMap;
+
+		AssetHandle<Texture> m_FireDiffuseMap;
 
-		std::unique_ptr<Texture> m_pFireDiffuseMap;
+		AssetHandle<MeshData> m_VehicleMeshData;
+		AssetHandle<MeshData> m_FireMeshData;
+
+		AssetHandle<const std::vector<char>> m_OpaqueEffect;
+		AssetHandle<const std::vector<char>> m_TransparentEffect;
 
 		////////////////////////////////////////////////////
 		//	Demonstration variables
@@ -109,6 +212,16 @@ namespace dae
 
 		//Render Mode
 		RenderMode m_RenderMode{ RenderMode::Combined };
+		ShadingQuality m_ShadingQuality{ ShadingQuality::Precise };
+
+		//Coarse shading, adaptive rates come from the previous software frame
+		ShadingRate m_ShadingRate{ ShadingRate::Rate1x1 };
+		std::unique_ptr<ShadingRateImage> m_pShadingRateImage;
+		bool m_UseTemporalCache{ false };
+
+		//Per pixel cost, counted by the meshes while a heatmap is shown
+		HeatmapMode m_HeatmapMode{ HeatmapMode::Off };
+		std::unique_ptr<Heatmap> m_pHeatmap;
 
 		//Color
 		ColorRGB m_BackColor{};
@@ -123,9 +236,21 @@ namespace dae
 		enum class FilteringMethod { Point, Linear, Anisotropic };
 		FilteringMethod m_FilteringMethod{ FilteringMethod::Point };
 
-		//Meshes
+		//Meshes, nullptr until their assets are loaded
+		VertexFormat m_VertexFormat{ VertexFormat::Full };
 		std::unique_ptr<MeshOpaque> m_pVehicleMesh;
 		std::unique_ptr<MeshTransparent> m_pFireMesh;
+
+		//Instances, every mesh is drawn once per instance
+		std::unique_ptr<Scene> m_pScene;
+		bool m_IsInstancing{ false };
+		const int m_NrInstanceColumns{ 16 };
+		const int m_NrInstanceRows{ 16 };
+
+		//Frustum culling, updated every frame
+		bool m_IsVehicleVisible{ true };
+		bool m_IsFireVisible{ true };
 		const float m_AngularSpeed{ 45.f * static_cast<float>(M_PI) / 180.f };
+		float m_RotationAngle{}; //Of both meshes, around y
 	};
 }
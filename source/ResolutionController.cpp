@@ -0,0 +1,106 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "ResolutionController.h"
+
+//---------------------------
+// Constructor & Destructor
+//---------------------------
+
+ResolutionController::ResolutionController(int maxWidth, int maxHeight, float budgetMilliseconds)
+	:m_MaxWidth{ maxWidth }
+	,m_MaxHeight{ maxHeight }
+	,m_BudgetMilliseconds{ budgetMilliseconds }
+	,m_Width{ maxWidth }
+	,m_Height{ maxHeight }
+{
+}
+
+//---------------------------
+// Member functions
+//---------------------------
+
+bool ResolutionController::Update(float renderMilliseconds)
+{
+	if (!m_IsEnabled) return false;
+
+	m_AverageMilliseconds = m_AverageMilliseconds > 0.f ? m_AverageMilliseconds + m_Smoothing * (renderMilliseconds - m_AverageMilliseconds) : renderMilliseconds;
+
+	//Frames right after a change still show the old cost in the average
+	if (++m_NrFramesSinceChange < m_NrSettleFrames) return false;
+
+	const float ratio{ m_AverageMilliseconds / m_BudgetMilliseconds };
+	if (ratio >= m_LowerBound && ratio <= m_UpperBound) return false;
+
+	//Aim for the budget, rounded down to a step so small differences don't resize the buffers
+	const float targetScale{ m_Scale / std::sqrt(ratio) };
+	const float scale{ std::clamp(std::floor(targetScale / m_ScaleStep) * m_ScaleStep, m_MinScale, 1.f) };
+
+	const float previousScale{ m_Scale };
+	if (!SetScale(scale)) return false;
+
+	//Predicted cost at the new scale, so the average doesn't start over
+	m_AverageMilliseconds *= (scale * scale) / (previousScale * previousScale);
+	return true;
+}
+
+void ResolutionController::Reset()
+{
+	m_AverageMilliseconds = 0.f;
+	m_NrFramesSinceChange = 0;
+}
+
+bool ResolutionController::SetEnabled(bool isEnabled)
+{
+	m_IsEnabled = isEnabled;
+	Reset();
+
+	return isEnabled ? false : SetScale(1.f);
+}
+
+bool ResolutionController::IsEnabled() const
+{
+	return m_IsEnabled;
+}
+
+int ResolutionController::GetWidth() const
+{
+	return m_Width;
+}
+
+int ResolutionController::GetHeight() const
+{
+	return m_Height;
+}
+
+float ResolutionController::GetScale() const
+{
+	return m_Scale;
+}
+
+float ResolutionController::GetAverageMilliseconds() const
+{
+	return m_AverageMilliseconds;
+}
+
+float ResolutionController::GetBudgetMilliseconds() const
+{
+	return m_BudgetMilliseconds;
+}
+
+bool ResolutionController::SetScale(float scale)
+{
+	const int width{ std::max(1, static_cast<int>(m_MaxWidth * scale + 0.5f)) };
+	const int height{ std::max(1, static_cast<int>(m_MaxHeight * scale + 0.5f)) };
+
+	m_NrFramesSinceChange = 0;
+
+	if (width == m_Width && height == m_Height) return false;
+
+	m_Scale = scale;
+	m_Width = width;
+	m_Height = height;
+
+	return true;
+}
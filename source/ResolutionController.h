@@ -0,0 +1,81 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+
+
+//-----------------------------------------------------
+// ResolutionController Class									
+//-----------------------------------------------------
+
+//Chooses the render resolution that keeps the render time of a frame within a budget.
+//Render time is assumed to grow with the number of pixels, so the scale of both axes follows the square root of the time ratio.
+//The scale moves in steps and waits for a few frames after every change, resizing the buffers is not free.
+class ResolutionController final
+{
+public:
+	ResolutionController(int maxWidth, int maxHeight, float budgetMilliseconds);
+	~ResolutionController() = default;
+
+	// -------------------------
+	// Copy/move constructors and assignment operators
+	// -------------------------    
+	ResolutionController(const ResolutionController& other) = delete;
+	ResolutionController(ResolutionController&& other) noexcept = delete;
+	ResolutionController& operator=(const ResolutionController& other) = delete;
+	ResolutionController& operator=(ResolutionController&& other)	noexcept = delete;
+
+	//-------------------------------------------------
+	// Member functions						
+	//-------------------------------------------------
+
+	//Returns true when the resolution changed
+	bool Update(float renderMilliseconds);
+
+	//Forgets the measured render times, for when the cost of a frame changes at once (another rasterizer)
+	void Reset();
+
+	//Disabled renders at the maximum resolution
+	bool SetEnabled(bool isEnabled);
+	bool IsEnabled() const;
+
+	int GetWidth() const;
+	int GetHeight() const;
+	float GetScale() const;
+	float GetAverageMilliseconds() const;
+	float GetBudgetMilliseconds() const;
+
+private:
+	//-------------------------------------------------
+	// Private member functions								
+	//-------------------------------------------------
+
+	//Returns true when the resolution changed
+	bool SetScale(float scale);
+
+	//-------------------------------------------------
+	// Datamembers								
+	//-------------------------------------------------
+	const int m_MaxWidth;
+	const int m_MaxHeight;
+	const float m_BudgetMilliseconds;
+
+	bool m_IsEnabled{ false };
+
+	float m_Scale{ 1.f };
+	int m_Width;
+	int m_Height;
+
+	//Exponential moving average, 0 until the first frame is measured
+	float m_AverageMilliseconds{};
+	int m_NrFramesSinceChange{};
+
+	static constexpr float m_MinScale{ 0.5f };
+	static constexpr float m_ScaleStep{ 0.0625f };
+	static constexpr float m_Smoothing{ 0.1f };
+	static constexpr int m_NrSettleFrames{ 15 };
+
+	//No change while the average is within [m_LowerBound, m_UpperBound] times the budget
+	static constexpr float m_LowerBound{ 0.8f };
+	static constexpr float m_UpperBound{ 1.05f };
+};
@@ -8,10 +8,13 @@ float gShininess = 25.f;
 float3 gAmbient = float3(0.025f, 0.025f, 0.025f);
 float3 gLightDirection = float3(0.577f, -0.577f, 0.577f);
 
-float4x4 gWorldViewProj : WorldViewProjection;
-float4x4 gWorld         : World;
+float4x4 gViewProj      : ViewProjection;
 float4x4 gViewInverse   : ViewInverse;
 
+//Compressed vertices (dae::CompressedVertex), position = gPositionOffset + quantized * gPositionScale, quantized in [0, 65535]
+float3 gPositionOffset = float3(0.f, 0.f, 0.f);
+float3 gPositionScale = float3(1.f, 1.f, 1.f);
+
 Texture2D gDiffuseMap    : DiffuseMap;
 Texture2D gNormalMap     : NormalMap;
 Texture2D gSpecularMap   : SpecularMap;
@@ -51,7 +54,17 @@ struct VS_INPUT
     float3 Position : POSITION;
     float2 UV		: TEXCOORD;
     float3 Normal	: NORMAL;
-    float3 Tangent	: TANGENT;
+    float4 Tangent	: TANGENT; //w: handedness
+    row_major float4x4 World	: WORLD; //Per instance, uploaded as the rows of dae::Matrix
+};
+
+struct VS_INPUT_COMPRESSED
+{
+    float4 Position : POSITION; //w: handedness, 0 or 1
+    float2 UV		: TEXCOORD;
+    float2 Normal	: NORMAL; //Octahedral
+    float2 Tangent	: TANGENT; //Octahedral
+    row_major float4x4 World	: WORLD; //Per instance, uploaded as the rows of dae::Matrix
 };
 
 struct VS_OUTPUT
@@ -61,27 +74,50 @@ struct VS_OUTPUT
     float2 UV			 : TEXCOORD;
     float3 Normal		 : NORMAL;
     float3 Tangent		 : TANGENT;
+	nointerpolation float Handedness : HANDEDNESS;
 };
 
 //---------------------------------------------------------------------------------
 //      Vertex Shader
 //---------------------------------------------------------------------------------
 
-VS_OUTPUT VS(VS_INPUT input)
+VS_OUTPUT TransformVertex(float3 position, float2 uv, float3 normal, float3 tangent, float handedness, float4x4 world)
 {
     VS_OUTPUT output = (VS_OUTPUT)0;
 
-	output.Position = mul(float4(input.Position, 1.f), gWorldViewProj);
-	output.WorldPosition = mul(float4(input.Position, 1.f), gWorld);
+	output.WorldPosition = mul(float4(position, 1.f), world);
+	output.Position = mul(output.WorldPosition, gViewProj);
 
-	output.UV = input.UV;
+	output.UV = uv;
 
-    output.Normal = mul(normalize(input.Normal), (float3x3)gWorld);
-	output.Tangent = mul(normalize(input.Tangent), (float3x3)gWorld);
+    output.Normal = mul(normalize(normal), (float3x3)world);
+	output.Tangent = mul(normalize(tangent), (float3x3)world);
+	output.Handedness = handedness;
 
     return output;
 }
 
+VS_OUTPUT VS(VS_INPUT input)
+{
+	return TransformVertex(input.Position, input.UV, input.Normal, input.Tangent.xyz, input.Tangent.w, input.World);
+}
+
+//Same as dae::VertexCompression::DecodeOctahedral
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 v = float3(encoded, 1.f - abs(encoded.x) - abs(encoded.y));
+	float fold = saturate(-v.z);
+	v.xy += (v.xy >= 0.f) ? -fold : fold;
+	return normalize(v);
+}
+
+VS_OUTPUT VS_Compressed(VS_INPUT_COMPRESSED input)
+{
+	float3 position = gPositionOffset + input.Position.xyz * 65535.f * gPositionScale;
+
+	return TransformVertex(position, input.UV, DecodeOctahedral(input.Normal), DecodeOctahedral(input.Tangent), 2.f * input.Position.w - 1.f, input.World);
+}
+
 //---------------------------------------------------------------------------------
 //      Pixel Shader
 //---------------------------------------------------------------------------------
@@ -98,7 +134,7 @@ float Phong(float ks, float exp, float3 l, float3 v, float3 n)
 
 float4 PS(VS_OUTPUT input) : SV_TARGET
 {
-    float3 binormal = cross(input.Normal, input.Tangent);
+    float3 binormal = input.Handedness * cross(input.Normal, input.Tangent);
 	float4x4 tangentSpaceAxis = float4x4(float4(input.Tangent, 0.f), float4(binormal, 0.f), float4(input.Normal, 0.f), float4(0.f, 0.f, 0.f, 1.f));
 
 	float3 sampledNormal = (2.f * gNormalMap.Sample(gSamplerState, input.UV).rgb) - float3(1.f, 1.f, 1.f);
@@ -131,4 +167,18 @@ technique11 DefaultTechnique
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
+}
+
+technique11 CompressedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+
+        SetVertexShader(CompileShader(vs_5_0, VS_Compressed()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
 }
\ No newline at end of file
@@ -8,7 +8,11 @@ float gShininess = 25.f;
 float3 gAmbient = float3(0.025f, 0.025f, 0.025f);
 float3 gLightDirection = float3(0.577f, -0.577f, 0.577f);
 
-float4x4 gWorldViewProj : WorldViewProjection;
+float4x4 gViewProj : ViewProjection;
+
+//Compressed vertices (dae::CompressedVertex), position = gPositionOffset + quantized * gPositionScale, quantized in [0, 65535]
+float3 gPositionOffset = float3(0.f, 0.f, 0.f);
+float3 gPositionScale = float3(1.f, 1.f, 1.f);
 Texture2D gDiffuseMap    : DiffuseMap;
 
 //---------------------------------------------------------------------------------
@@ -73,7 +77,17 @@ struct VS_INPUT
     float3 Position : POSITION;
     float2 UV		: TEXCOORD;
     float3 Normal	: NORMAL;
-    float3 Tangent	: TANGENT;
+    float4 Tangent	: TANGENT;
+    row_major float4x4 World	: WORLD; //Per instance, uploaded as the rows of dae::Matrix
+};
+
+struct VS_INPUT_COMPRESSED
+{
+    float4 Position : POSITION; //w: handedness, 0 or 1
+    float2 UV		: TEXCOORD;
+    float2 Normal	: NORMAL; //Octahedral
+    float2 Tangent	: TANGENT; //Octahedral
+    row_major float4x4 World	: WORLD; //Per instance, uploaded as the rows of dae::Matrix
 };
 
 struct VS_OUTPUT
@@ -90,7 +104,19 @@ VS_OUTPUT VS(VS_INPUT input)
 {
     VS_OUTPUT output = (VS_OUTPUT)0;
 
-	output.Position = mul(float4(input.Position, 1.f), gWorldViewProj);
+	output.Position = mul(mul(float4(input.Position, 1.f), input.World), gViewProj);
+	output.UV = input.UV;
+
+    return output;
+}
+
+VS_OUTPUT VS_Compressed(VS_INPUT_COMPRESSED input)
+{
+    VS_OUTPUT output = (VS_OUTPUT)0;
+
+	float3 position = gPositionOffset + input.Position.xyz * 65535.f * gPositionScale;
+
+	output.Position = mul(mul(float4(position, 1.f), input.World), gViewProj);
 	output.UV = input.UV;
 
     return output;
@@ -121,4 +147,18 @@ technique11 DefaultTechnique
         SetGeometryShader(NULL);
         SetPixelShader(CompileShader(ps_5_0, PS()));
     }
+}
+
+technique11 CompressedTechnique
+{
+    pass P0
+    {
+        SetRasterizerState(gRasterizerState);
+        SetDepthStencilState(gDepthStencilState, 0);
+        SetBlendState(gBlendState, float4(0.f, 0.f, 0.f, 0.f), 0xFFFFFFFF);
+
+        SetVertexShader(CompileShader(vs_5_0, VS_Compressed()));
+        SetGeometryShader(NULL);
+        SetPixelShader(CompileShader(ps_5_0, PS()));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "Scene.h"
+
+//---------------------------
+// Constructor & Destructor
+//---------------------------
+
+Scene::Scene()
+{
+	CreateSingle();
+}
+
+//---------------------------
+// Member functions
+//---------------------------
+
+void Scene::AddInstance(const dae::Matrix& transform)
+{
+	m_Instances.push_back(transform);
+}
+
+void Scene::ClearInstances()
+{
+	m_Instances.clear();
+}
+
+void Scene::CreateSingle()
+{
+	ClearInstances();
+	AddInstance(dae::Matrix{});
+}
+
+void Scene::CreateGrid(int nrColumns, int nrRows, float spacing)
+{
+	ClearInstances();
+	m_Instances.reserve(static_cast<size_t>(nrColumns) * nrRows);
+
+	const float halfWidth{ 0.5f * (nrColumns - 1) * spacing };
+
+	for (int row{}; row < nrRows; ++row)
+	{
+		for (int column{}; column < nrColumns; ++column)
+		{
+			AddInstance(dae::Matrix::CreateTranslation(column * spacing - halfWidth, 0.f, row * spacing));
+		}
+	}
+}
+
+const std::vector<dae::Matrix>& Scene::GetInstances() const
+{
+	return m_Instances;
+}
+
+size_t Scene::GetNrInstances() const
+{
+	return m_Instances.size();
+}
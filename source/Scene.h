@@ -0,0 +1,47 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+
+
+//-----------------------------------------------------
+// Scene Class									
+//-----------------------------------------------------
+
+//Placement of the copies of the scene objects.
+//Every mesh is loaded once and drawn for every instance transform, on top of its own world matrix.
+class Scene final
+{
+public:
+	Scene();
+	~Scene() = default;
+
+	// -------------------------
+	// Copy/move constructors and assignment operators
+	// -------------------------    
+	Scene(const Scene& other) = delete;
+	Scene(Scene&& other) noexcept = delete;
+	Scene& operator=(const Scene& other) = delete;
+	Scene& operator=(Scene&& other)	noexcept = delete;
+
+	//-------------------------------------------------
+	// Member functions						
+	//-------------------------------------------------
+	void AddInstance(const dae::Matrix& transform);
+	void ClearInstances();
+
+	//Replaces the instances with one instance at the origin
+	void CreateSingle();
+
+	//Replaces the instances with a grid on the xz plane, centered on x and starting at the origin going into the screen
+	void CreateGrid(int nrColumns, int nrRows, float spacing);
+
+	const std::vector<dae::Matrix>& GetInstances() const;
+	size_t GetNrInstances() const;
+
+private:
+	//-------------------------------------------------
+	// Datamembers								
+	//-------------------------------------------------
+	std::vector<dae::Matrix> m_Instances{};
+};
@@ -0,0 +1,173 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "SelfCheck.h"
+#include "Renderer.h"
+#include "AllocationCounter.h"
+
+namespace dae
+{
+	namespace SelfCheck
+	{
+		namespace
+		{
+			//Renders one frame, like the main loop does. Invalidated so it is rendered even when nothing changed
+			void RenderFrame(Renderer& renderer, Timer& timer)
+			{
+				SDL_PumpEvents();
+
+				renderer.Invalidate();
+				renderer.Update(&timer);
+				renderer.Render();
+
+				timer.Update();
+			}
+
+			//Loads on the worker threads, the meshes are created by Update once everything is there
+			bool WaitUntilLoaded(Renderer& renderer, Timer& timer)
+			{
+				constexpr double maxLoadSeconds{ 60.0 };
+
+				while (!renderer.IsLoaded())
+				{
+					if (timer.GetTotal() > maxLoadSeconds)
+					{
+						std::cout << "The assets did not load within " << maxLoadSeconds << " s\n";
+						return false;
+					}
+
+					RenderFrame(renderer, timer);
+				}
+
+				return true;
+			}
+		}
+
+		bool CheckFrameAllocations(Renderer& renderer, Timer& timer, int nrWarmUpFrames, int nrFrames)
+		{
+			std::cout << "----------------------------\n";
+			std::cout << "CHECK: HEAP ALLOCATIONS WHILE RENDERING\n";
+			std::cout << "----------------------------\n";
+
+			if (!isCountingHeapAllocations)
+			{
+				std::cout << "Heap allocations are not counted, build with COUNT_HEAP_ALLOCATIONS (the Debug configuration)\n";
+				return false;
+			}
+
+			renderer.ToggleVersion();
+			if (!WaitUntilLoaded(renderer, timer)) return false;
+
+			//Each configuration adds to the previous one, so the last one has every feature that uses transient memory
+			struct Configuration
+			{
+				const char* pName;
+				void (Renderer::*pToggle)();
+			};
+
+			const Configuration configurations[]
+			{
+				{ "DEFAULT", nullptr },
+				{ "4X MSAA", &Renderer::ToggleMultisampling },
+				{ "8X8 TILES", &Renderer::ToggleTiledLayout },
+				{ "TEMPORAL CACHE", &Renderer::ToggleTemporalCache },
+				{ "HEATMAP", &Renderer::ToggleHeatmap },
+				{ "HUD", &Renderer::ToggleHud },
+			};
+
+			bool isPassed{ true };
+
+			for (const Configuration& configuration : configurations)
+			{
+				if (configuration.pToggle) (renderer.*configuration.pToggle)();
+
+				//The buffers grow to this configuration
+				for (int frame{}; frame < nrWarmUpFrames; ++frame)
+				{
+					RenderFrame(renderer, timer);
+				}
+
+				uint64_t nrAllocations{};
+				for (int frame{}; frame < nrFrames; ++frame)
+				{
+					RenderFrame(renderer, timer);
+					nrAllocations += renderer.GetNrRenderAllocations();
+				}
+
+				std::cout << configuration.pName << ": " << nrAllocations << " allocations in " << nrFrames << " frames\n";
+				isPassed &= nrAllocations == 0;
+			}
+
+			std::cout << (isPassed ? "PASSED\n" : "FAILED\n");
+			std::cout << "----------------------------\n";
+
+			return isPassed;
+		}
+
+		bool CheckShadingAccuracy(Renderer& renderer, Timer& timer, int maxChannelError, float maxMeanError)
+		{
+			std::cout << "----------------------------\n";
+			std::cout << "CHECK: FAST MATH SHADING AGAINST PRECISE SHADING\n";
+			std::cout << "----------------------------\n";
+
+			renderer.ToggleVersion();
+			if (!WaitUntilLoaded(renderer, timer)) return false;
+
+			//The same frame twice: nothing moves, and the first shading quality is Precise
+			renderer.ToggleRotation();
+			RenderFrame(renderer, timer);
+
+			const FrameBuffer<uint32_t>& backBuffer{ renderer.GetBackBuffer() };
+			const FrameBufferLayout layout{ backBuffer.GetLayout() };
+			const std::vector<uint32_t> preciseColors(backBuffer.GetPixels(), backBuffer.GetPixels() + layout.planeSize);
+
+			renderer.ToggleShadingQuality();
+			RenderFrame(renderer, timer);
+
+			if (backBuffer.GetLayout().width != layout.width || backBuffer.GetLayout().height != layout.height)
+			{
+				std::cout << "The render resolution changed between the frames\n";
+				return false;
+			}
+
+			//The red, green and blue channels of the back buffer format, the unused byte is not compared
+			const SDL_PixelFormat* pFormat{ renderer.GetBackBufferFormat() };
+			const std::pair<uint32_t, uint32_t> channels[3]{ { pFormat->Rmask, pFormat->Rshift }, { pFormat->Gmask, pFormat->Gshift }, { pFormat->Bmask, pFormat->Bshift } };
+
+			int maxError{};
+			uint64_t totalError{};
+			int nrDifferentPixels{};
+
+			for (int py{}; py < layout.height; ++py)
+			{
+				for (int px{}; px < layout.width; ++px)
+				{
+					const int index{ layout.GetIndex(px, py) };
+					const uint32_t precise{ preciseColors[index] };
+					const uint32_t fast{ backBuffer.GetPixels()[index] };
+
+					nrDifferentPixels += precise != fast;
+
+					for (const auto& [mask, shift] : channels)
+					{
+						const int error{ std::abs(static_cast<int>((precise & mask) >> shift) - static_cast<int>((fast & mask) >> shift)) };
+
+						maxError = std::max(maxError, error);
+						totalError += error;
+					}
+				}
+			}
+
+			const float meanError{ static_cast<float>(totalError) / (3.f * layout.width * layout.height) };
+			const bool isPassed{ maxError <= maxChannelError && meanError <= maxMeanError };
+
+			std::cout << "Max channel error " << maxError << " (bound " << maxChannelError << "), mean error " << meanError << " (bound " << maxMeanError << ")\n";
+			std::cout << nrDifferentPixels << " of " << layout.width * layout.height << " pixels differ\n";
+			std::cout << (isPassed ? "PASSED\n" : "FAILED\n");
+			std::cout << "----------------------------\n";
+
+			return isPassed;
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+
+namespace dae
+{
+	class Renderer;
+	class Timer;
+
+	//Checks that render frames with the software rasterizer, run from the command line (see main).
+	//They print what they measured and return false when it is out of bounds
+	namespace SelfCheck
+	{
+		//Renders warm up frames in every listed configuration, then fails when one more frame allocates on the heap.
+		//Needs COUNT_HEAP_ALLOCATIONS (the Debug configuration), without it nothing is counted and the check fails
+		bool CheckFrameAllocations(Renderer& renderer, Timer& timer, int nrWarmUpFrames = 8, int nrFrames = 32);
+
+		//Renders the same frame with precise and with fast math shading (see FastMath.h) and compares the colors per channel.
+		//Fails when a channel is off by more than maxChannelError or the mean error is above maxMeanError (in 1 / 255)
+		bool CheckShadingAccuracy(Renderer& renderer, Timer& timer, int maxChannelError = 8, float maxMeanError = 0.5f);
+	}
+}
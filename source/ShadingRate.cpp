@@ -0,0 +1,93 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "ShadingRate.h"
+
+namespace dae
+{
+	//---------------------------
+	// Member functions
+	//---------------------------
+
+	void ShadingRateImage::Update(const uint32_t* pPixels, int stride, int width, int height, const SDL_PixelFormat* pFormat)
+	{
+		const int nrTilesX{ (width + tileSize - 1) / tileSize };
+		const int nrTilesY{ (height + tileSize - 1) / tileSize };
+
+		//Colors of another resolution don't describe the next frame
+		if (width != m_Width || height != m_Height)
+		{
+			m_Width = width;
+			m_Height = height;
+			m_NrTilesX = nrTilesX;
+			m_BlockSizes.assign(static_cast<size_t>(nrTilesX) * nrTilesY, Int2{ 1, 1 });
+			return;
+		}
+
+		//Approximate luminance (2r + 5g + b) / 8, from the channels of the back buffer format
+		const auto getLuminance = [pFormat](uint32_t pixel)
+		{
+			const int r{ static_cast<int>((pixel & pFormat->Rmask) >> pFormat->Rshift) };
+			const int g{ static_cast<int>((pixel & pFormat->Gmask) >> pFormat->Gshift) };
+			const int b{ static_cast<int>((pixel & pFormat->Bmask) >> pFormat->Bshift) };
+
+			return (2 * r + 5 * g + b) >> 3;
+		};
+
+		for (int tileY{}; tileY < nrTilesY; ++tileY)
+		{
+			for (int tileX{}; tileX < nrTilesX; ++tileX)
+			{
+				const int minX{ tileX * tileSize };
+				const int minY{ tileY * tileSize };
+				const int maxX{ std::min(minX + tileSize, width) - 1 };
+				const int maxY{ std::min(minY + tileSize, height) - 1 };
+
+				//Sum of the differences with the right and the lower neighbour, inside the tile
+				int gradientX{};
+				int gradientY{};
+
+				for (int py{ minY }; py <= maxY; ++py)
+				{
+					const uint32_t* pRow{ pPixels + py * stride };
+
+					for (int px{ minX }; px <= maxX; ++px)
+					{
+						const int luminance{ getLuminance(pRow[px]) };
+
+						if (px < maxX) gradientX += std::abs(getLuminance(pRow[px + 1]) - luminance);
+						if (py < maxY) gradientY += std::abs(getLuminance(pRow[px + stride]) - luminance);
+					}
+				}
+
+				const int nrPixels{ (maxX - minX + 1) * (maxY - minY + 1) };
+				const float meanGradientX{ gradientX / static_cast<float>(nrPixels) };
+				const float meanGradientY{ gradientY / static_cast<float>(nrPixels) };
+
+				Int2& blockSize{ m_BlockSizes[tileY * nrTilesX + tileX] };
+
+				if (std::max(meanGradientX, meanGradientY) < m_FlatGradient)
+				{
+					blockSize = { 4, 4 };
+				}
+				else if (std::max(meanGradientX, meanGradientY) < m_SmoothGradient)
+				{
+					blockSize = { 2, 2 };
+				}
+				else if (meanGradientX < m_SmoothGradient)
+				{
+					blockSize = { 2, 1 };
+				}
+				else if (meanGradientY < m_SmoothGradient)
+				{
+					blockSize = { 1, 2 };
+				}
+				else
+				{
+					blockSize = { 1, 1 };
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+#include "DataTypes.h"
+
+namespace dae
+{
+	//Size in pixels of the blocks that share one shading result, adaptive counts as 1x1 (see ShadingRateImage)
+	inline Int2 GetShadingBlockSize(ShadingRate shadingRate)
+	{
+		switch (shadingRate)
+		{
+		case ShadingRate::Rate1x2:
+			return { 1, 2 };
+		case ShadingRate::Rate2x1:
+			return { 2, 1 };
+		case ShadingRate::Rate2x2:
+			return { 2, 2 };
+		case ShadingRate::Rate4x4:
+			return { 4, 4 };
+		default:
+			return { 1, 1 };
+		}
+	}
+
+	//-----------------------------------------------------
+	// ShadingRateImage Class									
+	//-----------------------------------------------------
+
+	//Shading rate per screen tile, chosen from the luminance gradients of the previous frame.
+	//Flat tiles are shaded coarser, along the axis they are flat in. Tiles are a multiple of every block size, so blocks never cross them.
+	class ShadingRateImage final
+	{
+	public:
+		ShadingRateImage() = default;
+		~ShadingRateImage() = default;
+
+		ShadingRateImage(const ShadingRateImage& other) = delete;
+		ShadingRateImage(ShadingRateImage&& other) noexcept = delete;
+		ShadingRateImage& operator=(const ShadingRateImage& other) = delete;
+		ShadingRateImage& operator=(ShadingRateImage&& other) noexcept = delete;
+
+		static constexpr int tileSize{ 16 };
+
+		//From the final colors of a frame (stride pixels per row), the next frame uses the result. Resizes (to full rate) when the resolution changed
+		void Update(const uint32_t* pPixels, int stride, int width, int height, const SDL_PixelFormat* pFormat);
+
+		Int2 GetBlockSize(int px, int py) const
+		{
+			//Full rate outside of the previous frame, for the frame after a resize
+			if (px >= m_Width || py >= m_Height) return { 1, 1 };
+
+			return m_BlockSizes[(py / tileSize) * m_NrTilesX + px / tileSize];
+		}
+
+	private:
+		int m_Width{};
+		int m_Height{};
+		int m_NrTilesX{};
+		std::vector<Int2> m_BlockSizes{};
+
+		//Mean absolute luminance difference between neighbours, in 1/255
+		static constexpr float m_FlatGradient{ 1.5f };
+		static constexpr float m_SmoothGradient{ 4.f };
+	};
+}
@@ -0,0 +1,206 @@
+//---------------------------
+// Includes
+//---------------------------
+#include "pch.h"
+#include "TangentGenerator.h"
+#include <bit>
+#include <unordered_map>
+#include "Mesh.h"
+#include "Parallel.h"
+
+namespace
+{
+	//Weld key, the exact bits of everything that defines the tangent space of a vertex
+	struct VertexKey
+	{
+		uint32_t bits[8]{};
+
+		explicit VertexKey(const Vertex& vertex)
+		{
+			const float values[8]{ vertex.position.x, vertex.position.y, vertex.position.z, vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.uv.x, vertex.uv.y };
+
+			for (int index{}; index < 8; ++index)
+			{
+				//-0 and 0 are the same vertex
+				bits[index] = values[index] == 0.f ? 0u : std::bit_cast<uint32_t>(values[index]);
+			}
+		}
+
+		bool operator==(const VertexKey& other) const
+		{
+			return std::equal(std::begin(bits), std::end(bits), std::begin(other.bits));
+		}
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey& key) const
+		{
+			//FNV-1a
+			size_t hash{ 14695981039346656037ull };
+			for (uint32_t bits : key.bits)
+			{
+				hash = (hash ^ bits) * 1099511628211ull;
+			}
+			return hash;
+		}
+	};
+
+	//Mirrored and regular uv triangles are summed separately, otherwise their tangents cancel out on a mirror seam
+	struct TangentSum
+	{
+		dae::Vector3 tangent[2]{};
+		float weight[2]{};
+
+		TangentSum& operator+=(const TangentSum& other)
+		{
+			for (int orientation{}; orientation < 2; ++orientation)
+			{
+				tangent[orientation] += other.tangent[orientation];
+				weight[orientation] += other.weight[orientation];
+			}
+			return *this;
+		}
+	};
+
+	constexpr size_t minTrianglesPerTask{ 16 * 1024 };
+
+	//Triangles with (almost) no uv area do not define a tangent direction
+	constexpr float minUVArea{ 1e-12f };
+
+	float GetCornerAngle(const dae::Vector3& corner, const dae::Vector3& a, const dae::Vector3& b)
+	{
+		const dae::Vector3 edge0{ a - corner };
+		const dae::Vector3 edge1{ b - corner };
+
+		const float lengths{ std::sqrt(edge0.SqrMagnitude() * edge1.SqrMagnitude()) };
+		if (lengths == 0.f) return 0.f;
+
+		return std::acos(std::clamp(dae::Vector3::Dot(edge0, edge1) / lengths, -1.f, 1.f));
+	}
+
+	//Any unit vector perpendicular to the normal, for vertices that only belong to triangles without uv area
+	dae::Vector3 GetPerpendicular(const dae::Vector3& normal)
+	{
+		const dae::Vector3 axis{ std::abs(normal.x) < 0.9f ? dae::Vector3::UnitX : dae::Vector3::UnitY };
+		return dae::Vector3::Reject(axis, normal).Normalized();
+	}
+}
+
+namespace dae
+{
+	namespace Utils
+	{
+		void GenerateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+		{
+			//Weld
+			std::vector<uint32_t> groups(vertices.size());
+			uint32_t nrGroups{};
+			{
+				std::unordered_map<VertexKey, uint32_t, VertexKeyHash> groupOfKey{};
+				groupOfKey.reserve(vertices.size());
+
+				for (size_t index{}; index < vertices.size(); ++index)
+				{
+					const auto result{ groupOfKey.try_emplace(VertexKey{ vertices[index] }, nrGroups) };
+					groups[index] = result.first->second;
+					nrGroups += result.second;
+				}
+			}
+
+			//Accumulate, every task has its own sums so nothing is shared while writing
+			const size_t nrTriangles{ indices.size() / 3 };
+			const int nrTasks{ static_cast<int>(std::clamp<size_t>(nrTriangles / minTrianglesPerTask, 1, static_cast<size_t>(GetNrWorkers()))) };
+
+			std::vector<std::vector<TangentSum>> taskSums(nrTasks);
+
+			ParallelFor(nrTasks, [&](int task)
+				{
+					std::vector<TangentSum>& sums{ taskSums[task] };
+					sums.resize(nrGroups);
+
+					const size_t firstTriangle{ nrTriangles * task / nrTasks };
+					const size_t lastTriangle{ nrTriangles * (task + 1) / nrTasks };
+
+					for (size_t triangle{ firstTriangle }; triangle < lastTriangle; ++triangle)
+					{
+						const uint32_t triangleIndices[3]{ indices[triangle * 3], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+
+						const Vertex& v0{ vertices[triangleIndices[0]] };
+						const Vertex& v1{ vertices[triangleIndices[1]] };
+						const Vertex& v2{ vertices[triangleIndices[2]] };
+
+						const Vector3 edge0{ v1.position - v0.position };
+						const Vector3 edge1{ v2.position - v0.position };
+						const Vector2 uvEdge0{ v1.uv - v0.uv };
+						const Vector2 uvEdge1{ v2.uv - v0.uv };
+
+						const float uvArea{ Vector2::Cross(uvEdge0, uvEdge1) };
+						if (std::abs(uvArea) < minUVArea) continue;
+
+						//dP/du and dP/dv
+						const float inverseUVArea{ 1.f / uvArea };
+						const Vector3 tangent{ (edge0 * uvEdge1.y - edge1 * uvEdge0.y) * inverseUVArea };
+						const Vector3 bitangent{ (edge1 * uvEdge0.x - edge0 * uvEdge1.x) * inverseUVArea };
+
+						for (int corner{}; corner < 3; ++corner)
+						{
+							const Vertex& vertex{ vertices[triangleIndices[corner]] };
+							const Vector3& previous{ vertices[triangleIndices[(corner + 2) % 3]].position };
+							const Vector3& next{ vertices[triangleIndices[(corner + 1) % 3]].position };
+
+							const float angle{ GetCornerAngle(vertex.position, next, previous) };
+
+							//0: bitangent = cross(normal, tangent), 1: mirrored
+							const int orientation{ Vector3::Dot(Vector3::Cross(vertex.normal, tangent), bitangent) < 0.f };
+
+							const Vector3 projectedTangent{ Vector3::Reject(tangent, vertex.normal) };
+							if (projectedTangent.SqrMagnitude() == 0.f) continue;
+
+							TangentSum& sum{ sums[groups[triangleIndices[corner]]] };
+							sum.tangent[orientation] += projectedTangent.Normalized() * angle;
+							sum.weight[orientation] += angle;
+						}
+					}
+				});
+
+			//Reduce, split over the groups this time
+			ParallelFor(nrTasks, [&](int task)
+				{
+					const size_t firstGroup{ static_cast<size_t>(nrGroups) * task / nrTasks };
+					const size_t lastGroup{ static_cast<size_t>(nrGroups) * (task + 1) / nrTasks };
+
+					for (size_t group{ firstGroup }; group < lastGroup; ++group)
+					{
+						for (int otherTask{ 1 }; otherTask < nrTasks; ++otherTask)
+						{
+							taskSums[0][group] += taskSums[otherTask][group];
+						}
+					}
+				});
+
+			const std::vector<TangentSum>& sums{ taskSums[0] };
+
+			for (size_t index{}; index < vertices.size(); ++index)
+			{
+				Vertex& vertex{ vertices[index] };
+				const TangentSum& sum{ sums[groups[index]] };
+
+				//A vertex on a mirror seam takes the side that covers most of it
+				const int orientation{ sum.weight[1] > sum.weight[0] };
+				const Vector3 tangent{ Vector3::Reject(sum.tangent[orientation], vertex.normal) };
+
+				if (tangent.SqrMagnitude() > 0.f)
+				{
+					vertex.tangent = tangent.Normalized();
+				}
+				else
+				{
+					vertex.tangent = GetPerpendicular(vertex.normal);
+				}
+
+				vertex.handedness = orientation ? -1.f : 1.f;
+			}
+		}
+	}
+}
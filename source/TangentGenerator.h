@@ -0,0 +1,17 @@
+#pragma once
+//-----------------------------------------------------
+// Include Files
+//-----------------------------------------------------
+struct Vertex;
+
+namespace dae
+{
+	namespace Utils
+	{
+		//MikkTSpace style tangents: for every corner the triangle's dP/du and dP/dv are projected on the corner normal and weighted by the corner angle.
+		//Corners with the same position, normal and uv are welded, so tangents are smooth over shared vertices.
+		//Triangles are spread over worker threads that accumulate separately, followed by a parallel reduce.
+		//The bitangent is handedness * cross(normal, tangent), in the software and the DirectX pixel shader.
+		void GenerateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+	}
+}
@@ -13,6 +13,9 @@
 Texture::Texture(ID3D11Device* pDevice, const std::string& path)
 	:m_pSurface{ IMG_Load(path.c_str()) }
 {
+	//Missing or unreadable file, GetResource returns nullptr (see AssetManager::LoadTexture)
+	if (!m_pSurface) return;
+
 	DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	D3D11_TEXTURE2D_DESC desc{};
 	desc.Width = m_pSurface->w;
@@ -48,8 +51,8 @@ Texture::Texture(ID3D11Device* pDevice, const std::string& path)
 
 Texture::~Texture()
 {
-	m_pSRV->Release();
-	m_pResource->Release();
+	if (m_pSRV) m_pSRV->Release();
+	if (m_pResource) m_pResource->Release();
 
 	SDL_FreeSurface(m_pSurface);
 }
@@ -63,6 +66,11 @@ ID3D11ShaderResourceView* Texture::GetResource() const
 	return m_pSRV;
 }
 
+size_t Texture::GetMemoryUsage() const
+{
+	return static_cast<size_t>(m_pSurface->pitch) * m_pSurface->h;
+}
+
 dae::ColorRGB Texture::SampleRGB(const dae::Vector2& uv) const
 {
 	Uint8 red{}, green{}, blue{};
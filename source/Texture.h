@@ -26,10 +26,14 @@ public:
 	//-------------------------------------------------
 	// Member functions						
 	//-------------------------------------------------
+	//nullptr when the texture could not be loaded
 	ID3D11ShaderResourceView* GetResource() const;
 
 	dae::ColorRGB SampleRGB(const dae::Vector2& uv) const;
 	dae::Vector4 SampleRGBA(const dae::Vector2& uv) const;
+
+	//Bytes of the pixels the software rasterizer samples, the DirectX copy is the same size
+	size_t GetMemoryUsage() const;
 private:
 	//-------------------------------------------------
 	// Private member functions								
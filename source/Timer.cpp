@@ -1,35 +1,49 @@
 #include "pch.h"
 #include "Timer.h"
+#include <chrono>
 
 namespace dae
 {
-	Timer::Timer()
+	Timer::Timer(Clock clock)
+		:m_Clock{ clock }
 	{
-		const uint64_t countsPerSecond = SDL_GetPerformanceFrequency();
-		m_SecondsPerCount = 1.0f / static_cast<float>(countsPerSecond);
+		if (m_Clock == Clock::Steady)
+		{
+			using Period = std::chrono::steady_clock::period;
+			m_SecondsPerCount = static_cast<double>(Period::num) / static_cast<double>(Period::den);
+		}
+		else
+		{
+			const uint64_t countsPerSecond = SDL_GetPerformanceFrequency();
+			m_SecondsPerCount = 1.0 / static_cast<double>(countsPerSecond);
+		}
 	}
 
 	void Timer::Reset()
 	{
-		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const uint64_t currentTime = GetCounter();
 
 		m_BaseTime = currentTime;
 		m_PreviousTime = currentTime;
+		m_LapTime = currentTime;
+		m_PausedTime = 0;
 		m_StopTime = 0;
-		m_FPSTimer = 0.0f;
+		m_FPSTimer = 0.0;
 		m_FPSCount = 0;
+		m_NrLaps = 0;
 		m_IsStopped = false;
 	}
 
 	void Timer::Start()
 	{
-		const uint64_t startTime = SDL_GetPerformanceCounter();
+		const uint64_t startTime = GetCounter();
 
 		if (m_IsStopped)
 		{
 			m_PausedTime += (startTime - m_StopTime);
 
 			m_PreviousTime = startTime;
+			m_LapTime = startTime;
 			m_StopTime = 0;
 			m_IsStopped = false;
 		}
@@ -40,36 +54,45 @@ namespace dae
 		if (m_IsStopped)
 		{
 			m_FPS = 0;
-			m_ElapsedTime = 0.0f;
-			m_TotalTime = static_cast<float>(((m_StopTime - m_PausedTime) - m_BaseTime) * m_BaseTime);
+			m_ElapsedTime = 0.0;
+			m_TotalTime = static_cast<double>((m_StopTime - m_PausedTime) - m_BaseTime) * m_SecondsPerCount;
 			return;
 		}
 
-		const uint64_t currentTime = SDL_GetPerformanceCounter();
+		const uint64_t currentTime = GetCounter();
 		m_CurrentTime = currentTime;
 
-		m_ElapsedTime = static_cast<float>(m_CurrentTime - m_PreviousTime) * m_SecondsPerCount;
+		//Unsigned, a counter that went back would wrap around
+		m_ElapsedTime = m_CurrentTime > m_PreviousTime ? static_cast<double>(m_CurrentTime - m_PreviousTime) * m_SecondsPerCount : 0.0;
 		m_PreviousTime = m_CurrentTime;
 
-		if (m_ElapsedTime < 0.0f)
-			m_ElapsedTime = 0.0f;
+		//The real frame time, before it is bounded
+		const uint32_t frame{ m_NrRecordedFrames.load(std::memory_order_relaxed) };
+		m_FrameTimes[frame % nrFrameTimes].store(m_ElapsedTime * 1000.0, std::memory_order_relaxed);
+		m_NrRecordedFrames.store(frame + 1, std::memory_order_release);
 
 		if (m_ForceElapsedUpperBound && m_ElapsedTime > m_ElapsedUpperBound)
 		{
 			m_ElapsedTime = m_ElapsedUpperBound;
 		}
 
-		m_TotalTime = static_cast<float>(m_CurrentTime - m_PausedTime - m_BaseTime) * m_SecondsPerCount;
+		m_TotalTime = static_cast<double>(m_CurrentTime - m_PausedTime - m_BaseTime) * m_SecondsPerCount;
+
+		//Laps
+		m_FrameLaps = m_Laps;
+		m_NrFrameLaps = m_NrLaps;
+		m_NrLaps = 0;
+		m_LapTime = m_CurrentTime;
 
 		//FPS LOGIC
 		m_FPSTimer += m_ElapsedTime;
 		++m_FPSCount;
-		if (m_FPSTimer >= 1.0f)
+		if (m_FPSTimer >= 1.0)
 		{
-			m_dFPS = static_cast<float>(m_FPSCount) / m_FPSTimer;
+			m_dFPS = static_cast<double>(m_FPSCount) / m_FPSTimer;
 			m_FPS = m_FPSCount;
 			m_FPSCount = 0;
-			m_FPSTimer = 0.0f;
+			m_FPSTimer = 0.0;
 		}
 	}
 
@@ -77,10 +100,53 @@ namespace dae
 	{
 		if (!m_IsStopped)
 		{
-			const uint64_t currentTime = SDL_GetPerformanceCounter();
+			const uint64_t currentTime = GetCounter();
 
 			m_StopTime = currentTime;
 			m_IsStopped = true;
 		}
 	}
-}
\ No newline at end of file
+
+	void Timer::Lap(const char* pName)
+	{
+		if (m_IsStopped || m_NrLaps >= maxNrLaps) return;
+
+		const uint64_t currentTime = GetCounter();
+
+		m_Laps[m_NrLaps++] = { pName, static_cast<double>(currentTime - m_LapTime) * m_SecondsPerCount * 1000.0 };
+		m_LapTime = currentTime;
+	}
+
+	double Timer::GetFrameTimePercentile(float percentile) const
+	{
+		const uint32_t nrFrameTimes{ GetNrFrameTimes() };
+		if (nrFrameTimes == 0) return 0.0;
+
+		std::array<double, Timer::nrFrameTimes> frameTimes{};
+		for (uint32_t index{}; index < nrFrameTimes; ++index)
+		{
+			frameTimes[index] = m_FrameTimes[index].load(std::memory_order_relaxed);
+		}
+
+		//Nearest rank
+		const uint32_t rank{ static_cast<uint32_t>(std::clamp(percentile, 0.f, 1.f) * (nrFrameTimes - 1) + 0.5f) };
+		std::nth_element(frameTimes.begin(), frameTimes.begin() + rank, frameTimes.begin() + nrFrameTimes);
+
+		return frameTimes[rank];
+	}
+
+	uint32_t Timer::GetNrFrameTimes() const
+	{
+		return std::min(m_NrRecordedFrames.load(std::memory_order_acquire), nrFrameTimes);
+	}
+
+	uint64_t Timer::GetCounter() const
+	{
+		if (m_Clock == Clock::Steady)
+		{
+			return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+		}
+
+		return SDL_GetPerformanceCounter();
+	}
+}
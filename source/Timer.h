@@ -1,14 +1,31 @@
 #pragma once
 
 //Standard includes
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 namespace dae
 {
+	//Frame timer of the main loop, also used to time benchmark runs.
+	//Times are kept as 64 bit counts and converted in double precision, so they stay exact after long uptimes.
 	class Timer
 	{
 	public:
-		Timer();
+		//SDL performance counter, or std::chrono::steady_clock (no SDL needed)
+		enum class Clock { Performance, Steady };
+
+		//Time between two laps (or the previous Update and the first lap) of one frame
+		struct LapTime
+		{
+			const char* pName{}; //Not copied, use string literals
+			double milliseconds{};
+		};
+
+		static constexpr uint32_t nrFrameTimes{ 256 };
+		static constexpr uint32_t maxNrLaps{ 8 };
+
+		explicit Timer(Clock clock = Clock::Performance);
 		virtual ~Timer() = default;
 
 		Timer(const Timer&) = delete;
@@ -21,30 +38,56 @@ namespace dae
 		void Update();
 		void Stop();
 
+		//Marks the end of a stage of the current frame, the laps of a frame are available after its Update
+		void Lap(const char* pName);
+
 		uint32_t GetFPS() const { return m_FPS; };
-		float GetdFPS() const { return m_dFPS; };
-		float GetElapsed() const { return m_ElapsedTime; };
-		float GetTotal() const { return m_TotalTime; };
+		float GetdFPS() const { return static_cast<float>(m_dFPS); };
+		float GetElapsed() const { return static_cast<float>(m_ElapsedTime); };
+		double GetTotal() const { return m_TotalTime; };
 		bool IsRunning() const { return !m_IsStopped; };
 
+		//Frame times of the last nrFrameTimes updates, in milliseconds. percentile in [0, 1], 0 is the fastest frame.
+		//Lock free, other threads can read while the timer updates (a frame time that is being replaced may be either one)
+		double GetFrameTimePercentile(float percentile) const;
+		uint32_t GetNrFrameTimes() const;
+
+		uint32_t GetNrLaps() const { return m_NrFrameLaps; };
+		const LapTime& GetLap(uint32_t index) const { return m_FrameLaps[index]; };
+
 	private:
-		uint64_t m_BaseTime = 0;
-		uint64_t m_PausedTime = 0;
-		uint64_t m_StopTime = 0;
-		uint64_t m_PreviousTime = 0;
-		uint64_t m_CurrentTime = 0;
-
-		uint32_t m_FPS = 0;
-		float m_dFPS = 0.0f;
-		uint32_t m_FPSCount = 0;
-
-		float m_TotalTime = 0.0f;
-		float m_ElapsedTime = 0.0f;
-		float m_SecondsPerCount = 0.0f;
-		float m_ElapsedUpperBound = 0.03f;
-		float m_FPSTimer = 0.0f;
-
-		bool m_IsStopped = true;
-		bool m_ForceElapsedUpperBound = false;
+		uint64_t GetCounter() const;
+
+		const Clock m_Clock;
+		double m_SecondsPerCount{};
+
+		uint64_t m_BaseTime{};
+		uint64_t m_PausedTime{};
+		uint64_t m_StopTime{};
+		uint64_t m_PreviousTime{};
+		uint64_t m_CurrentTime{};
+
+		uint32_t m_FPS{};
+		double m_dFPS{};
+		uint32_t m_FPSCount{};
+
+		double m_TotalTime{};
+		double m_ElapsedTime{};
+		double m_ElapsedUpperBound{ 0.03 };
+		double m_FPSTimer{};
+
+		bool m_IsStopped{ true };
+		bool m_ForceElapsedUpperBound{ false };
+
+		//Rolling window, written at m_NrRecordedFrames % nrFrameTimes
+		std::array<std::atomic<double>, nrFrameTimes> m_FrameTimes{};
+		std::atomic<uint32_t> m_NrRecordedFrames{};
+
+		//Laps of the frame in progress and of the last finished frame
+		uint64_t m_LapTime{};
+		std::array<LapTime, maxNrLaps> m_Laps{};
+		uint32_t m_NrLaps{};
+		std::array<LapTime, maxNrLaps> m_FrameLaps{};
+		uint32_t m_NrFrameLaps{};
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include <cassert>
+#include "Math.h"
+
+namespace dae
+{
+	//Linear function of raster space: value(x, y) = c + dx * x + dy * y
+	struct PlaneEquation
+	{
+		float c{};
+		float dx{};
+		float dy{};
+
+		float Evaluate(float x, float y) const
+		{
+			return c + dx * x + dy * y;
+		}
+	};
+
+	//Everything that is constant over a triangle, calculated once before rasterization.
+	//The edge planes are the barycentric weights, so a pixel is inside when all three are positive (independent of winding).
+	//Attribute planes store attribute / w, multiplying with the interpolated w gives the perspective correct value.
+	struct TriangleSetup
+	{
+		enum Plane { Weight0, Weight1, Weight2, InverseDepth, InverseW, FirstAttribute };
+		//Opaque meshes use 16, 19 with the previous positions of the temporal cache
+		static constexpr int maxPlanes{ 20 };
+
+		PlaneEquation planes[maxPlanes]{};
+		int nrPlanes{ FirstAttribute };
+
+		//Bounding box in raster space, clamped to the screen
+		Int2 min{};
+		Int2 max{};
+
+		//Positions are in raster space, w contains 1 / w (see VertexTransformationFunction)
+		bool Setup(const Vector4& p0, const Vector4& p1, const Vector4& p2, int width, int height)
+		{
+			const float area{ Vector2::Cross(p1.GetXY() - p0.GetXY(), p2.GetXY() - p0.GetXY()) };
+			if (area == 0.f) return false;
+
+			const float inverseArea{ 1.f / area };
+
+			planes[Weight0] = CreateEdge(p1, p2, inverseArea);
+			planes[Weight1] = CreateEdge(p2, p0, inverseArea);
+			planes[Weight2] = CreateEdge(p0, p1, inverseArea);
+
+			planes[InverseDepth] = CreatePlane(1.f / p0.z, 1.f / p1.z, 1.f / p2.z);
+			planes[InverseW] = CreatePlane(p0.w, p1.w, p2.w);
+
+			m_InverseW[0] = p0.w;
+			m_InverseW[1] = p1.w;
+			m_InverseW[2] = p2.w;
+
+			nrPlanes = FirstAttribute;
+
+			//Get values for boundingbox
+			min.x = std::max(0, static_cast<int>(std::min(p0.x, std::min(p1.x, p2.x))));
+			min.y = std::max(0, static_cast<int>(std::min(p0.y, std::min(p1.y, p2.y))));
+			max.x = std::min(width - 1, static_cast<int>(std::max(p0.x, std::max(p1.x, p2.x))));
+			max.y = std::min(height - 1, static_cast<int>(std::max(p0.y, std::max(p1.y, p2.y))));
+
+			return min.x <= max.x && min.y <= max.y;
+		}
+
+		//Returns the index of the first plane of the attribute
+		int AddAttribute(float a0, float a1, float a2)
+		{
+			assert(nrPlanes < maxPlanes);
+
+			planes[nrPlanes] = CreatePlane(a0 * m_InverseW[0], a1 * m_InverseW[1], a2 * m_InverseW[2]);
+			return nrPlanes++;
+		}
+
+		int AddAttribute(const Vector2& a0, const Vector2& a1, const Vector2& a2)
+		{
+			const int first{ AddAttribute(a0.x, a1.x, a2.x) };
+			AddAttribute(a0.y, a1.y, a2.y);
+			return first;
+		}
+
+		int AddAttribute(const Vector3& a0, const Vector3& a1, const Vector3& a2)
+		{
+			const int first{ AddAttribute(a0.x, a1.x, a2.x) };
+			AddAttribute(a0.y, a1.y, a2.y);
+			AddAttribute(a0.z, a1.z, a2.z);
+			return first;
+		}
+
+	private:
+		//Edge function cross(b - a, p - a), divided by the area so it becomes the barycentric weight of the opposite vertex
+		static PlaneEquation CreateEdge(const Vector4& a, const Vector4& b, float inverseArea)
+		{
+			const float dx{ (a.y - b.y) * inverseArea };
+			const float dy{ (b.x - a.x) * inverseArea };
+
+			return { -(dx * a.x + dy * a.y), dx, dy };
+		}
+
+		PlaneEquation CreatePlane(float a0, float a1, float a2) const
+		{
+			return
+			{
+				a0 * planes[Weight0].c + a1 * planes[Weight1].c + a2 * planes[Weight2].c,
+				a0 * planes[Weight0].dx + a1 * planes[Weight1].dx + a2 * planes[Weight2].dx,
+				a0 * planes[Weight0].dy + a1 * planes[Weight1].dy + a2 * planes[Weight2].dy
+			};
+		}
+
+		float m_InverseW[3]{};
+	};
+
+	//Walks the planes of a TriangleSetup along a row, one add per plane per pixel
+	struct TriangleSpan
+	{
+		float values[TriangleSetup::maxPlanes]{};
+
+		void Begin(const TriangleSetup& setup, float x, float y)
+		{
+			for (int plane{}; plane < setup.nrPlanes; ++plane)
+			{
+				values[plane] = setup.planes[plane].Evaluate(x, y);
+			}
+		}
+
+		void Step(const TriangleSetup& setup)
+		{
+			for (int plane{}; plane < setup.nrPlanes; ++plane)
+			{
+				values[plane] += setup.planes[plane].dx;
+			}
+		}
+
+		float GetDepth() const
+		{
+			return 1.f / values[TriangleSetup::InverseDepth];
+		}
+
+		float GetW() const
+		{
+			return 1.f / values[TriangleSetup::InverseW];
+		}
+
+		Vector2 GetVector2(int plane, float w) const
+		{
+			return { values[plane] * w, values[plane + 1] * w };
+		}
+
+		Vector3 GetVector3(int plane, float w) const
+		{
+			return { values[plane] * w, values[plane + 1] * w, values[plane + 2] * w };
+		}
+
+		//The same span moved by a fraction of a pixel, without stepping it
+		TriangleSpan GetOffset(const TriangleSetup& setup, float x, float y) const
+		{
+			TriangleSpan offset{};
+
+			for (int plane{}; plane < setup.nrPlanes; ++plane)
+			{
+				offset.values[plane] = values[plane] + setup.planes[plane].dx * x + setup.planes[plane].dy * y;
+			}
+
+			return offset;
+		}
+	};
+
+	//Sample positions in a pixel, relative to the corner the spans are evaluated at.
+	//One sample is the corner itself, four samples use the standard D3D11 rotated grid.
+	template<int nrSamples>
+	struct SamplePattern;
+
+	template<>
+	struct SamplePattern<1>
+	{
+		static constexpr float x[1]{ 0.f };
+		static constexpr float y[1]{ 0.f };
+	};
+
+	template<>
+	struct SamplePattern<4>
+	{
+		static constexpr float x[4]{ 0.375f, 0.875f, 0.125f, 0.625f };
+		static constexpr float y[4]{ 0.125f, 0.375f, 0.625f, 0.875f };
+	};
+
+	//Edge and depth planes at the samples of a pixel, as offsets from the span values at its corner.
+	//The buffers hold one plane per sample (sample major), with one sample that is an ordinary buffer. The index of a pixel depends on the layout (see FrameBuffer).
+	template<int nrSamples>
+	struct TriangleSamples
+	{
+		float weightOffsets[3][nrSamples]{};
+		float inverseDepthOffsets[nrSamples]{};
+
+		explicit TriangleSamples(const TriangleSetup& setup)
+		{
+			for (int sample{}; sample < nrSamples; ++sample)
+			{
+				const float x{ SamplePattern<nrSamples>::x[sample] };
+				const float y{ SamplePattern<nrSamples>::y[sample] };
+
+				for (int weight{}; weight < 3; ++weight)
+				{
+					const PlaneEquation& plane{ setup.planes[TriangleSetup::Weight0 + weight] };
+					weightOffsets[weight][sample] = plane.dx * x + plane.dy * y;
+				}
+
+				const PlaneEquation& inverseDepth{ setup.planes[TriangleSetup::InverseDepth] };
+				inverseDepthOffsets[sample] = inverseDepth.dx * x + inverseDepth.dy * y;
+			}
+		}
+
+		//A bit per sample inside the triangle, branchless so the samples can be tested side by side
+		uint32_t GetCoverage(const TriangleSpan& span) const
+		{
+			uint32_t coverage{};
+
+			for (int sample{}; sample < nrSamples; ++sample)
+			{
+				const bool isInside
+				{
+					(span.values[TriangleSetup::Weight0] + weightOffsets[0][sample] > 0.f) &
+					(span.values[TriangleSetup::Weight1] + weightOffsets[1][sample] > 0.f) &
+					(span.values[TriangleSetup::Weight2] + weightOffsets[2][sample] > 0.f)
+				};
+
+				coverage |= static_cast<uint32_t>(isInside) << sample;
+			}
+
+			return coverage;
+		}
+
+		//Depth test of the covered samples, returns a bit per sample that passed.
+		//Writes the depth of those samples when writeDepth (opaque), blended geometry only tests.
+		template<bool writeDepth>
+		uint32_t DepthTest(const TriangleSpan& span, uint32_t coverage, float* pDepthBufferPixels, int bufferIndex, int planeSize) const
+		{
+			uint32_t passed{};
+
+			for (int sample{}; sample < nrSamples; ++sample)
+			{
+				if (!(coverage >> sample & 0x01)) continue;
+
+				const float depth{ 1.f / (span.values[TriangleSetup::InverseDepth] + inverseDepthOffsets[sample]) };
+				float& bufferDepth{ pDepthBufferPixels[sample * planeSize + bufferIndex] };
+
+				if (depth < bufferDepth)
+				{
+					if constexpr (writeDepth)
+					{
+						bufferDepth = depth;
+					}
+
+					passed |= 1u << sample;
+				}
+			}
+
+			return passed;
+		}
+	};
+}
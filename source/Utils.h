@@ -3,6 +3,8 @@
 #include "Math.h"
 #include <vector>
 #include "Mesh.h"
+#include "TangentGenerator.h"
+#include "MeshOptimizer.h"
 
 namespace dae
 {
@@ -36,6 +38,25 @@ namespace dae
 			return false;
 		}
 
+		//Calculates the tangents, converts to a left handed coordinate system and shares identical vertices, shared by the OBJ parsers
+		inline void FinalizeOBJ(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+		{
+			//Tangents are generated in the final space, so the handedness matches the flipped winding
+			if (flipAxisAndWinding)
+			{
+				for (Vertex& vertex : vertices)
+				{
+					vertex.position.z *= -1.f;
+					vertex.normal.z *= -1.f;
+				}
+			}
+
+			GenerateTangents(vertices, indices);
+
+			//Every face corner is its own vertex until here, strips and the vertex cache need shared vertices
+			WeldVertices(vertices, indices);
+		}
+
 		//Just parses vertices and indices
 #pragma warning(push)
 #pragma warning(disable : 4505) //Warning unreferenced local function
@@ -53,11 +74,10 @@ namespace dae
 			indices.clear();
 
 			std::string sCommand;
-			// start a while iteration ending when the end of file is reached (ios::eof)
-			while (!file.eof())
+			//read the first word of the string, use the >> operator (istream::operator>>)
+			//stops when there is no word left, checking eof() first would repeat the last command at the end of the file
+			while (file >> sCommand)
 			{
-				//read the first word of the string, use the >> operator (istream::operator>>) 
-				file >> sCommand;
 				//use conditional statements to process the different commands	
 				if (sCommand == "#")
 				{
@@ -145,45 +165,7 @@ namespace dae
 				file.ignore(1000, '\n');
 			}
 
-			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-			
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
-			
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-			
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
-
-			//Create the Tangents (reject)
-			for (auto& v : vertices)
-			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if(flipAxisAndWinding)
-				{
-					v.position.z *= -1.f;
-					v.normal.z *= -1.f;
-					v.tangent.z *= -1.f;
-				}
-
-			}
+			FinalizeOBJ(vertices, indices, flipAxisAndWinding);
 
 			return true;
 		}
@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include "Math.h"
+#include "Frustum.h"
+
+namespace dae
+{
+	//20 bytes instead of the 48 of a Vertex, the DirectX formats are in Effect.cpp.
+	//position: 16 bit unorm relative to the bounding box of the mesh, w is the handedness (0: -1, 1: 1)
+	//uv: half floats, normal and tangent: 16 bit snorm octahedral encoding
+	struct CompressedVertex
+	{
+		uint16_t position[4]{};
+		uint16_t uv[2]{};
+		int16_t normal[2]{};
+		int16_t tangent[2]{};
+	};
+
+	static_assert(sizeof(CompressedVertex) == 20);
+
+	//position = offset + quantized * scale, with the quantized values in [0, 65535]
+	struct PositionQuantization
+	{
+		Vector3 offset{};
+		Vector3 scale{ 1.f, 1.f, 1.f };
+
+		static PositionQuantization Create(const BoundingBox& boundingBox)
+		{
+			PositionQuantization quantization{ boundingBox.min };
+
+			for (int axis{}; axis < 3; ++axis)
+			{
+				const float extent{ boundingBox.max[axis] - boundingBox.min[axis] };
+				quantization.scale[axis] = extent > 0.f ? extent / 65535.f : 1.f;
+			}
+
+			return quantization;
+		}
+	};
+
+	namespace VertexCompression
+	{
+		inline uint16_t EncodeUnorm(float value)
+		{
+			return static_cast<uint16_t>(std::clamp(value, 0.f, 1.f) * 65535.f + 0.5f);
+		}
+
+		inline float DecodeUnorm(uint16_t value)
+		{
+			return value / 65535.f;
+		}
+
+		inline int16_t EncodeSnorm(float value)
+		{
+			return static_cast<int16_t>(std::round(std::clamp(value, -1.f, 1.f) * 32767.f));
+		}
+
+		//-32768 and -32767 are both -1, like DXGI_FORMAT_R16G16_SNORM
+		inline float DecodeSnorm(int16_t value)
+		{
+			return std::max(value / 32767.f, -1.f);
+		}
+
+		//Rounds to the nearest even half, too large values become infinity
+		inline uint16_t FloatToHalf(float value)
+		{
+			const uint32_t bits{ std::bit_cast<uint32_t>(value) };
+			const uint32_t sign{ (bits >> 16) & 0x8000 };
+			const int exponent{ static_cast<int>((bits >> 23) & 0xFF) - 127 + 15 };
+			uint32_t mantissa{ bits & 0x007FFFFF };
+
+			//Infinity and NaN
+			if ((bits & 0x7FFFFFFF) >= 0x7F800000) return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x0200 : 0));
+
+			if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00);
+
+			//Denormal halves
+			if (exponent <= 0)
+			{
+				if (exponent < -10) return static_cast<uint16_t>(sign);
+
+				mantissa |= 0x00800000;
+
+				const int shift{ 14 - exponent };
+				const uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+				const uint32_t halfway{ 1u << (shift - 1) };
+
+				uint32_t half{ mantissa >> shift };
+				if (remainder > halfway || (remainder == halfway && (half & 1))) ++half;
+
+				return static_cast<uint16_t>(sign | half);
+			}
+
+			//A carry out of the mantissa correctly increments the exponent
+			uint32_t half{ (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13) };
+			const uint32_t remainder{ mantissa & 0x1FFF };
+			if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) ++half;
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		inline float HalfToFloat(uint16_t half)
+		{
+			const uint32_t sign{ static_cast<uint32_t>(half & 0x8000) << 16 };
+			const uint32_t exponent{ (half >> 10) & 0x1Fu };
+			const uint32_t mantissa{ half & 0x03FFu };
+
+			if (exponent == 0)
+			{
+				const float denormal{ std::ldexp(static_cast<float>(mantissa), -24) };
+				return sign ? -denormal : denormal;
+			}
+
+			if (exponent == 31) return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+
+			return std::bit_cast<float>(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+		}
+
+		//Projects the unit vector on an octahedron and unfolds the lower half over the corners
+		inline void EncodeOctahedral(const Vector3& v, int16_t encoded[2])
+		{
+			const float length{ std::abs(v.x) + std::abs(v.y) + std::abs(v.z) };
+			if (length == 0.f)
+			{
+				encoded[0] = encoded[1] = 0;
+				return;
+			}
+
+			float x{ v.x / length };
+			float y{ v.y / length };
+
+			if (v.z < 0.f)
+			{
+				const float foldedX{ (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f) };
+				const float foldedY{ (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+
+				x = foldedX;
+				y = foldedY;
+			}
+
+			encoded[0] = EncodeSnorm(x);
+			encoded[1] = EncodeSnorm(y);
+		}
+
+		//Same as DecodeOctahedral in the effect files
+		inline Vector3 DecodeOctahedral(const int16_t encoded[2])
+		{
+			Vector3 v{ DecodeSnorm(encoded[0]), DecodeSnorm(encoded[1]), 0.f };
+			v.z = 1.f - std::abs(v.x) - std::abs(v.y);
+
+			const float fold{ std::max(-v.z, 0.f) };
+			v.x += v.x >= 0.f ? -fold : fold;
+			v.y += v.y >= 0.f ? -fold : fold;
+
+			return v.Normalized();
+		}
+
+		inline Vector3 DecodePosition(const CompressedVertex& vertex, const PositionQuantization& quantization)
+		{
+			return
+			{
+				quantization.offset.x + vertex.position[0] * quantization.scale.x,
+				quantization.offset.y + vertex.position[1] * quantization.scale.y,
+				quantization.offset.z + vertex.position[2] * quantization.scale.z
+			};
+		}
+
+		inline Vector2 DecodeUV(const CompressedVertex& vertex)
+		{
+			return { HalfToFloat(vertex.uv[0]), HalfToFloat(vertex.uv[1]) };
+		}
+
+		inline float DecodeHandedness(const CompressedVertex& vertex)
+		{
+			return vertex.position[3] != 0 ? 1.f : -1.f;
+		}
+	}
+}
@@ -6,6 +6,9 @@
 
 #undef main
 #include "Renderer.h"
+#include "ObjParser.h"
+#include "FramePacer.h"
+#include "SelfCheck.h"
 
 using namespace dae;
 
@@ -17,9 +20,20 @@ void ShutDown(SDL_Window* pWindow)
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	//Compare the OBJ parsers and exit: --benchmark-obj [files]
+	if (argc > 1 && std::string{ args[1] } == "--benchmark-obj")
+	{
+		std::vector<std::string> files{ "Resources/vehicle.obj", "Resources/fireFX.obj" };
+		if (argc > 2) files.assign(args + 2, args + argc);
+
+		bool isEqual{ true };
+		for (const std::string& file : files)
+		{
+			isEqual &= dae::Utils::BenchmarkOBJ(file);
+		}
+
+		return isEqual ? 0 : 1;
+	}
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -40,8 +54,24 @@ int main(int argc, char* args[])
 	const auto pTimer = new Timer();
 	const auto pRenderer = new Renderer(pWindow);
 
+	//Render the checks in software and exit: --check-allocations or --check-shading
+	if (argc > 1 && (std::string{ args[1] } == "--check-allocations" || std::string{ args[1] } == "--check-shading"))
+	{
+		pTimer->Start();
+		const bool isPassed = std::string{ args[1] } == "--check-allocations" ? SelfCheck::CheckFrameAllocations(*pRenderer, *pTimer) : SelfCheck::CheckShadingAccuracy(*pRenderer, *pTimer);
+
+		delete pRenderer;
+		delete pTimer;
+		ShutDown(pWindow);
+
+		return isPassed ? 0 : 1;
+	}
+
 	bool printFPS = false;
 
+	//Same rate as the frame budget of the dynamic resolution
+	FramePacer framePacer{ 60.f };
+
 	//Start loop
 	pTimer->Start();
 	float printTimer = 0.f;
@@ -58,6 +88,10 @@ int main(int argc, char* args[])
 			case SDL_QUIT:
 				isLooping = false;
 				break;
+			case SDL_WINDOWEVENT:
+				if (e.window.event == SDL_WINDOWEVENT_EXPOSED)
+					pRenderer->Invalidate();
+				break;
 			case SDL_KEYUP:
 				if (e.key.keysym.scancode == SDL_SCANCODE_F1)
 					pRenderer->ToggleVersion();
@@ -87,16 +121,67 @@ int main(int argc, char* args[])
 					std::cout << "PRINT FPS: " << (printFPS ? "ON" : "OFF") << '\n';
 					std::cout << "----------------------------\n";
 				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+					pRenderer->ToggleShadingQuality();
+				if (e.key.keysym.scancode == SDL_SCANCODE_I)
+					pRenderer->ToggleInstancing();
+				if (e.key.keysym.scancode == SDL_SCANCODE_V)
+					pRenderer->ToggleVertexFormat();
+				if (e.key.keysym.scancode == SDL_SCANCODE_M)
+					pRenderer->ToggleMultisampling();
+				if (e.key.keysym.scancode == SDL_SCANCODE_R)
+					pRenderer->ToggleDynamicResolution();
+				if (e.key.keysym.scancode == SDL_SCANCODE_C)
+					pRenderer->ToggleShadingRate();
+				if (e.key.keysym.scancode == SDL_SCANCODE_T)
+					pRenderer->ToggleTemporalCache();
+				if (e.key.keysym.scancode == SDL_SCANCODE_H)
+					pRenderer->ToggleHud();
+				if (e.key.keysym.scancode == SDL_SCANCODE_G)
+					pRenderer->ToggleHeatmap();
+				if (e.key.keysym.scancode == SDL_SCANCODE_L)
+					pRenderer->ToggleTiledLayout();
+				if (e.key.keysym.scancode == SDL_SCANCODE_P)
+				{
+					const FramePacer::Mode mode = framePacer.GetMode() == FramePacer::Mode::VSync ? FramePacer::Mode::Uncapped : static_cast<FramePacer::Mode>(static_cast<int>(framePacer.GetMode()) + 1);
+					framePacer.SetMode(mode);
+					pRenderer->SetVSync(mode == FramePacer::Mode::VSync);
+
+					std::cout << "----------------------------\n";
+					std::cout << "FRAME PACING: ";
+					switch (mode)
+					{
+					case FramePacer::Mode::Uncapped:
+						std::cout << "UNCAPPED\n";
+						break;
+					case FramePacer::Mode::TargetFPS:
+						std::cout << framePacer.GetTargetFPS() << " FPS\n";
+						break;
+					case FramePacer::Mode::VSync:
+						std::cout << "VSYNC (" << framePacer.GetTargetFPS() << " FPS IN SOFTWARE)\n";
+						break;
+					}
+					std::cout << "----------------------------\n";
+				}
 				break;
 			default: ;
 			}
 		}
 
+		pTimer->Lap("Input");
+
 		//--------- Update ---------
 		pRenderer->Update(pTimer);
+		pTimer->Lap("Update");
 
 		//--------- Render ---------
-		pRenderer->Render();
+		const bool isRendered = pRenderer->Render();
+		pTimer->Lap("Render");
+
+		//--------- Pacing ---------
+		//Nothing changed, wait for input instead of spinning
+		framePacer.EndFrame(!isRendered, pRenderer->IsVSyncActive());
+		pTimer->Lap("Wait");
 
 		//--------- Timer ---------
 		pTimer->Update();
@@ -106,6 +191,20 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			std::cout << "Frame time (last " << pTimer->GetNrFrameTimes() << " frames): " << pTimer->GetFrameTimePercentile(0.5f) << " ms median, "
+				<< pTimer->GetFrameTimePercentile(0.99f) << " ms 99th percentile, " << pTimer->GetFrameTimePercentile(1.f) << " ms worst\n";
+
+			std::cout << "Last frame:";
+			for (uint32_t lap = 0; lap < pTimer->GetNrLaps(); ++lap)
+			{
+				std::cout << ' ' << pTimer->GetLap(lap).pName << ' ' << pTimer->GetLap(lap).milliseconds << " ms";
+			}
+			std::cout << '\n';
+
+			std::cout << "Frame pacing: " << framePacer.GetAverageIntervalMilliseconds() << " ms average, "
+				<< framePacer.GetJitterMilliseconds() << " ms jitter, " << framePacer.GetMaxIntervalMilliseconds() << " ms worst\n";
+			framePacer.ResetStatistics();
+			pRenderer->PrintStatistics();
 		}
 	}
 	pTimer->Stop();